@@ -44,9 +44,39 @@ void r8ErrorHandler(R8_ERROR_HANDLER_PROC errorHandler);
 /// Gets the string description for the given enum code.
 const char* r8GetString(R8enum str);
 
-/// Returns the integer value for the enum code.
+/**
+Returns the integer value for the enum code.
+\param[in] param Specifies the parameter whose value is to be returned. Valid values are:
+- R8_MAX_TEXTURE_SIZE: Returns the maximal texture width and height.
+- R8_THREAD_COUNT: Returns the number of threads which rasterize triangles. By default 1.
+- R8_MAX_THREAD_COUNT: Returns the maximal number of rasterizer threads.
+- R8_HIZ_REJECTED_SPANS: Returns the number of spans of the bound frame buffer, which have been rejected by the Hi-Z test since its depth buffer has been cleared.
+- R8_HIZ_REJECTED_PIXELS: Returns the number of pixels of the bound frame buffer, which have been rejected by the Hi-Z test since its depth buffer has been cleared.
+- R8_VERTEX_CACHE_HITS: Returns the number of indexed triangle vertices, which have been reused from the post-transform vertex cache since the depth buffer of the bound frame buffer has been cleared.
+- R8_VERTEX_CACHE_MISSES: Returns the number of indexed triangle vertices, which have been transformed since the depth buffer of the bound frame buffer has been cleared.
+\remarks The hit rate of the vertex cache is R8_VERTEX_CACHE_HITS / (R8_VERTEX_CACHE_HITS + R8_VERTEX_CACHE_MISSES).
+Indexed draw calls with at least as many indices as the vertex buffer has vertices transform the whole vertex buffer in one batch,
+in which case every vertex of the buffer counts as a miss and all remaining indices count as hits.
+- R8_CULLED_DRAWS: Returns the number of draw calls, which have been skipped since the depth buffer of the bound frame buffer has been cleared,
+because the bounding volume of their vertex buffer is entirely outside of the view volume.
+\remarks The bounding volume of a vertex buffer is computed by r8VertexBufferData and r8VertexBufferDataFromFile, and taken from the file header by r8LoadMesh.
+Draw calls from the immediate mode (r8Begin/r8End) are never culled.
+- R8_CULLED_MESHLETS: Returns the number of meshlets, which have been skipped since the depth buffer of the bound frame buffer has been cleared,
+because their bounding sphere is outside of the view volume or all of their triangles are culled by the cull mode (see r8BuildMeshlets).
+*/
 R8int r8GetIntegerv(R8enum param);
 
+/**
+Sets the number of threads which rasterize triangles.
+\param[in] threadCount Specifies the number of threads (including the calling thread). Must be in the range [1, R8_MAX_THREAD_COUNT].
+If this is greater than 1, the triangles are binned into screen tiles of 64x64 pixels
+and the tiles are rasterized in parallel (sort-middle). The result is identical to the single threaded rasterization.
+\remarks Binned triangles are rasterized when the frame buffer is cleared, bound, or presented,
+or before points, lines, and images are drawn.
+\see r8GetIntegerv
+*/
+void r8SetThreadCount(R8int threadCount);
+
 /**************************************************
  *                                                *
  *                    Context                     *
@@ -87,9 +117,25 @@ Clears the specified frame buffer.
 \param[in] clearFlags Specifies the clear flags. This can be a bitwise OR combination of the following bit masks:
 - R8_COLOR_BUFFER_BIT: Clears the color buffer.
 - R8_DEPTH_BUFFER_BIT: Clears the depth buffer.
+\remarks If R8_SCISSOR is enabled, only the area inside the scissor rectangle is cleared.
+Large areas are cleared with SIMD stores and distributed over the rasterizer threads (see r8SetThreadCount).
+\see r8Scissor
+\see r8InvalidateFrameBuffer
 */
 void r8ClearFrameBuffer(R8object frameBuffer, R8float clearDepth, R8bitfield clearFlags);
 
+/**
+Invalidates the specified frame buffer, i.e. it will be cleared lazily.
+Instead of clearing all pixels, each 64x64 pixel tile is only marked as pending and it's cleared when it's accessed for the first time
+(by rasterized primitives, screen space drawing, or r8Present). Tiles which are entirely overdrawn are still cleared once.
+\param[in] frameBuffer Specifies the frame buffer which is to be invalidated.
+\param[in] clearDepth Specifies the depth value to clear the depth buffer.
+\param[in] clearFlags Specifies the clear flags. This can be a bitwise OR combination of R8_COLOR_BUFFER_BIT and R8_DEPTH_BUFFER_BIT.
+\remarks The current clear color (see r8ClearColor) is stored with the pending clears. The scissor rectangle is ignored.
+\see r8ClearFrameBuffer
+*/
+void r8InvalidateFrameBuffer(R8object frameBuffer, R8float clearDepth, R8bitfield clearFlags);
+
 // --- texture --- //
 
 /**
@@ -205,6 +251,7 @@ Reads and sets the vertex buffer data from the specified file.
 \code
 // File format:
 numVertices: 16-bit unsigned integer
+[numVertices32: 32-bit unsigned integer, only if 'numVertices' is 0xFFFF]
 vertices[numVertices]: 'numVertices' * (five 32-bit floating point values for: x, y, z, u, v) (see 'R8vertex').
 \endcode
 \see R8vertex
@@ -239,11 +286,24 @@ void r8DeleteIndexBuffer(R8object indexBuffer);
 /**
 Sets the index buffer data.
 \param[in] indexBuffer Specifies the index buffer whose vertex data is to be set.
-\param[in] indices Pointer to the index data. Only 16-bit unsigned integers are allowed as vertex indices.
+\param[in] indices Pointer to the index data of 16-bit unsigned integers.
 \param[in] numIndices Specifies the number of indices. The array 'indices' must be large enough!
+\remarks This sets the index type of the buffer to R8_UNSIGNED_SHORT.
+\see r8IndexBufferData32
 */
 void r8IndexBufferData(R8object indexBuffer, const R8ushort* indices, R8sizei numIndices);
 
+/**
+Sets the index buffer data with 32-bit indices.
+\param[in] indexBuffer Specifies the index buffer whose vertex data is to be set.
+\param[in] indices Pointer to the index data of 32-bit unsigned integers.
+\param[in] numIndices Specifies the number of indices. The array 'indices' must be large enough!
+\remarks This sets the index type of the buffer to R8_UNSIGNED_INT.
+Use this only for vertex buffers with more than 65536 vertices, otherwise prefer the more compact 'r8IndexBufferData'.
+\see r8IndexBufferData
+*/
+void r8IndexBufferData32(R8object indexBuffer, const R8uint* indices, R8sizei numIndices);
+
 /**
 Reads and sets the index buffer data from the specified file.
 \param[in] indexBuffer Specifies the index buffer whose index data is to be set.
@@ -252,8 +312,10 @@ Reads and sets the index buffer data from the specified file.
 \code
 // File format:
 numIndices: 16-bit unsigned integer
-indices[numVertices]: 'numIndices' * (16-bit unsigned integer).
+[numIndices32: 32-bit unsigned integer, only if 'numIndices' is 0xFFFF]
+indices[numIndices]: 'numIndices' * (16-bit unsigned integer), or 'numIndices32' * (32-bit unsigned integer).
 \endcode
+\remarks The index type of the buffer is R8_UNSIGNED_INT if the file has a 32-bit count, and R8_UNSIGNED_SHORT otherwise.
 */
 void r8IndexBufferDataFromFile(R8object indexBuffer, R8sizei* numIndices, FILE* file);
 
@@ -264,6 +326,91 @@ If this is zero, no index buffer is bound.
 */
 void r8BindIndexBuffer(R8object indexBuffer);
 
+/**
+Splits the triangle list of the specified index buffer into meshlets (clusters of 64 consecutive triangles)
+with a bounding sphere and a normal cone each, so that indexed draw calls can reject entire clusters before any of their vertices is transformed.
+\param[in] indexBuffer Specifies the index buffer whose triangles are to be clustered.
+\param[in] vertexBuffer Specifies the vertex buffer the indices refer to.
+\remarks This is optional and only affects 'r8DrawIndexed' with R8_TRIANGLES, when the same vertex buffer is bound
+and the first index is a multiple of 3. The meshlets are released when the index data is replaced,
+and they are ignored after the vertex data has been replaced, until they are rebuilt. The triangles should be ordered for locality first (e.g. with the mesh optimizer tool),
+because the clusters are taken in the order of the index buffer.
+\see R8_CULLED_MESHLETS
+*/
+void r8BuildMeshlets(R8object indexBuffer, R8object vertexBuffer);
+
+// --- mesh --- //
+
+/**
+Loads a mesh from the specified file in the binary mesh format by mapping the file into memory.
+\param[in] filename Specifies the mesh file, which must have been written by 'r8SaveMesh'.
+\return Mesh object or zero if the file could not be mapped or has an invalid header or version.
+\remarks The vertex streams and indices are used in place (zero-copy), so loading only touches the file header.
+The pages of the file are read by the operating system when they are accessed, and draw calls transform at most
+a bounded number of vertices at once (see R8_MAX_BATCH_VERTICES in r8_config.h), so even meshes which are larger than the available memory can be drawn.
+The mesh must be deleted with 'r8DeleteMesh'.
+\code
+// File format (all offsets are aligned to 16 bytes):
+magic: 32-bit unsigned integer "R8MS"
+version: 32-bit unsigned integer
+numVertices, numIndices, indexType, fileSize: 32-bit unsigned integers
+boundsMin[3], boundsMax[3]: 32-bit floating point values
+coordOffsets[4], texCoordOffsets[2], indicesOffset, reserved: 32-bit unsigned integers
+streams X, Y, Z, W, U, V: 'numVertices' * (32-bit floating point value) each
+indices: 'numIndices' * (16-bit or 32-bit unsigned integer, see 'indexType')
+\endcode
+\see r8SaveMesh
+\see r8DeleteMesh
+*/
+R8object r8LoadMesh(const char* filename);
+
+/**
+Deletes the specified mesh and unmaps its file.
+\param[in] mesh Specifies the mesh which is to be deleted. This must be loaded by 'r8LoadMesh'.
+\remarks The vertex- and index buffers of the mesh must no longer be used after the mesh has been deleted.
+*/
+void r8DeleteMesh(R8object mesh);
+
+/**
+Writes the specified vertex- and index buffer to a file in the binary mesh format.
+\param[in] filename Specifies the output filename.
+\param[in] vertexBuffer Specifies the vertex buffer whose vertices are to be written.
+\param[in] indexBuffer Optional index buffer whose indices are to be written. May be zero.
+\return R8_TRUE on success, otherwise R8_FALSE.
+\see r8LoadMesh
+*/
+R8boolean r8SaveMesh(const char* filename, R8object vertexBuffer, R8object indexBuffer);
+
+/**
+Returns the vertex buffer of the specified mesh, which can be bound with 'r8BindVertexBuffer'.
+\remarks This vertex buffer is owned by the mesh and must not be deleted with 'r8DeleteVertexBuffer'.
+*/
+R8object r8GetMeshVertexBuffer(R8object mesh);
+
+/**
+Returns the index buffer of the specified mesh, which can be bound with 'r8BindIndexBuffer'.
+\remarks This index buffer is owned by the mesh and must not be deleted with 'r8DeleteIndexBuffer'.
+*/
+R8object r8GetMeshIndexBuffer(R8object mesh);
+
+/**
+Returns a parameter of the specified mesh.
+\param[in] mesh Specifies the mesh whose parameter is to be determined.
+\param[in] param Specifies the parameter which is to be determined.
+- R8_MESH_NUM_VERTICES: Returns the number of vertices.
+- R8_MESH_NUM_INDICES: Returns the number of indices.
+- R8_MESH_INDEX_TYPE: Returns the index type (R8_UNSIGNED_SHORT or R8_UNSIGNED_INT).
+*/
+R8int r8GetMeshParameteri(R8object mesh, R8enum param);
+
+/**
+Returns the axis-aligned bounding box of the specified mesh, as stored in its file.
+\param[in] mesh Specifies the mesh whose bounding box is to be determined.
+\param[out] boundsMin Pointer to an array of three floats which receives the minimum of the bounding box.
+\param[out] boundsMax Pointer to an array of three floats which receives the maximum of the bounding box.
+*/
+void r8GetMeshBounds(R8object mesh, R8float* boundsMin, R8float* boundsMax);
+
 // --- matrices --- //
 
 /**
@@ -346,6 +493,17 @@ void r8LoadIdentity(R8float* matrix4x4);
 Sets the specified state.
 \param[in] cap Specifies the capability whose state is to be changed. Valid values are:
 - R8_SCISSOR - Enables/disables the scissor rectangle (see r8Scissor). By default R8_FALSE.
+- R8_MIP_MAPPING - Enables/disables MIP-mapping for textured polygons. By default R8_FALSE.
+- R8_HALF_SPACE - Enables/disables the half-space rasterizer for filled polygons.
+Instead of walking scanlines, it tests blocks of pixels against integer edge functions (with SSE2/AVX2 if available). By default R8_FALSE.
+- R8_HIERARCHICAL_Z - Enables/disables the hierarchical depth buffer (Hi-Z). The frame buffer keeps the farthest depth of each 8x8 pixel tile,
+and spans which are entirely behind it are skipped without touching their pixels. By default R8_FALSE.
+- R8_DEPTH_PARITY - Enables/disables the frame-parity depth trick. Each frame only uses one half of the depth range,
+and clearing (or invalidating) the entire depth buffer with a depth of 0.0 only flips the depth values of the previous frame behind that range instead of touching any pixel.
+This halves the depth precision and requires that each frame covers all pixels, otherwise depth values from two frames ago become visible again.
+The state takes effect with the next depth clear, which then clears all pixels once. By default R8_FALSE.
+- R8_PRIMITIVE_RESTART - Enables/disables the primitive restart index for indexed line strips, line loops, triangle strips, and triangle fans.
+The largest value of the index type (0xFFFF for 16-bit and 0xFFFFFFFF for 32-bit indices) then ends the current strip, loop, or fan and starts a new one. By default R8_FALSE.
 \param[in] state Specifies the new state.
 \see r8Enable
 \see r8Disable
@@ -425,7 +583,7 @@ void r8Color(R8ubyte r, R8ubyte g, R8ubyte b);
 /// Draws a single 2D point onto the screen.
 void r8DrawScreenPoint(R8int x, R8int y);
 
-/// Draws a single 2D line onto the screen.
+/// Draws a single 2D line onto the screen. The line is clipped against the frame buffer and its end point is not drawn.
 void r8DrawScreenLine(R8int x1, R8int y1, R8int x2, R8int y2);
 
 /// Draws a single 2D image with the currently bound texture.
@@ -440,7 +598,7 @@ R8_POINTS, R8_LINES, R8_LINE_STRIP, R8_LINE_LOOP, R8_TRIANGLES, R8_TRIANGLE_STRI
 \remarks A vertex buffer must be bound.
 \see r8BindVertexBuffer
 */
-void r8Draw(R8enum priitives, R8ushort numVertices, R8ushort firstVertex);
+void r8Draw(R8enum priitives, R8sizei numVertices, R8sizei firstVertex);
 
 /**
 Draws the specified amount of priitives.
@@ -452,7 +610,35 @@ R8_POINTS, R8_LINES, R8_LINE_STRIP, R8_LINE_LOOP, R8_TRIANGLES, R8_TRIANGLE_STRI
 \see r8BindVertexBuffer
 \see r8BindIndexBuffer
 */
-void r8DrawIndexed(R8enum priitives, R8ushort numVertices, R8ushort firstVertex);
+void r8DrawIndexed(R8enum priitives, R8sizei numVertices, R8sizei firstVertex);
+
+/**
+Draws the specified amount of indexed priitives once for each instance.
+\param[in] priitives Specifies the priitive types (see r8DrawIndexed). R8_POINTS is not supported.
+\param[in] numVertices Specifies the number of vertices to draw for each instance.
+\param[in] firstVertex Specifies the first vertex to draw.
+\param[in] numInstances Specifies the number of instances.
+\param[in] worldMatrices Raw pointer to 'numInstances' consecutive 4x4 left-handed world matrices (16 floats each), one for each instance.
+\remarks This is equivalent to calling r8WorldMatrix and r8DrawIndexed for each world matrix, but the draw call is only validated once
+and the world-view-projection matrices of the instances are computed in batches. The current world matrix (see r8WorldMatrix) is not modified.
+\see r8DrawIndexed
+*/
+void r8DrawIndexedInstanced(R8enum priitives, R8sizei numVertices, R8sizei firstVertex, R8sizei numInstances, const R8float* worldMatrices);
+
+/**
+Draws several ranges of indexed priitives with a single call.
+\param[in] priitives Specifies the priitive types (see r8DrawIndexed). R8_POINTS is not supported.
+\param[in] numRanges Specifies the number of ranges.
+\param[in] firstVertices Array of 'numRanges' elements which specify the first vertex of each range.
+\param[in] numVertices Array of 'numRanges' elements which specify the number of vertices of each range.
+\param[in] textures Optional array of 'numRanges' textures, one for each range. A null entry draws its range with the current color.
+If this is null, all ranges are drawn with the bound texture (see r8BindTexture).
+\remarks This is equivalent to calling r8BindTexture and r8DrawIndexed for each range, but the draw call is only validated once
+and the ranges of a triangle list share the same vertex transformation. Ranges of lines are textured in the same way as ranges of triangles.
+The bound texture is not modified.
+\see r8DrawIndexed
+*/
+void r8MultiDrawIndexed(R8enum priitives, R8sizei numRanges, const R8sizei* firstVertices, const R8sizei* numVertices, const R8object* textures);
 
 // --- immediate mode --- //
 
@@ -481,9 +667,10 @@ r8End();
 \encode
 \remarks This is equivalent to drawing the priitives with a vertex buffer (but no index buffer).
 \note This is slower than using a vertex buffer. A global immediate vertex buffer is used,
-to draw the priitives. This internal global buffer is severely limited (by default 32 vertices).
+to draw the priitives. This internal global buffer grows on demand (up to 65536 vertices) and is drawn with a single call at r8End.
 However, you can drawn unlimited priitives, since the buffer works like a stream,
-which will be flushed when it's full (i.e. the current content will be drawn to the frame buffer).
+which will be flushed when it's full or when a state is changed (i.e. the current content will be drawn to the frame buffer).
+The shared vertices of strips, fans, and loops are kept across such flushes.
 \see r8End
 \see r8Draw
 */
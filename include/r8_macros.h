@@ -20,6 +20,14 @@
 
 // r8GetIntegerv arguments
 #define R8_MAX_TEXTURE_SIZE 0x00000021
+#define R8_THREAD_COUNT     0x00000022
+#define R8_MAX_THREAD_COUNT 0x00000023
+#define R8_HIZ_REJECTED_SPANS   0x00000024
+#define R8_HIZ_REJECTED_PIXELS  0x00000025
+#define R8_VERTEX_CACHE_HITS    0x00000026
+#define R8_VERTEX_CACHE_MISSES  0x00000027
+#define R8_CULLED_DRAWS         0x00000028
+#define R8_CULLED_MESHLETS      0x00000029
 
 // Geometry primitives
 #define R8_POINTS           0x00000031
@@ -44,9 +52,22 @@
 #define R8_TEXTURE_WIDTH    0x00000060
 #define R8_TEXTURE_HEIGHT   0x00000061
 
+// Index types
+#define R8_UNSIGNED_SHORT   0x00000070
+#define R8_UNSIGNED_INT     0x00000071
+
+// r8GetMeshParameteri arguments
+#define R8_MESH_NUM_VERTICES    0x00000080
+#define R8_MESH_NUM_INDICES     0x00000081
+#define R8_MESH_INDEX_TYPE      0x00000082
+
 // States
 #define R8_SCISSOR          0
 #define R8_MIP_MAPPING      1
+#define R8_HALF_SPACE       2
+#define R8_HIERARCHICAL_Z   3
+#define R8_DEPTH_PARITY     4
+#define R8_PRIMITIVE_RESTART 5
 
 // Texture environment parameters
 #define R8_TEXTURE_LOD_BIAS 0
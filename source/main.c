@@ -7,6 +7,8 @@
 #include <Windows.h>
 #include <windowsx.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include <r8.h>
 #include <stdbool.h>
 #include <math.h>
@@ -14,6 +16,7 @@
 
 #include <r8_image.h>
 #include <r8_matrix4.h>
+#include <r8_pixel.h>
 
 
 // --- global members --- //
@@ -65,6 +68,60 @@ static void MoveCam(float x, float z)
 
 #define PI 3.141592654f
 
+//#define BENCHMARK_CLEAR
+#ifdef BENCHMARK_CLEAR
+
+#define BENCHMARK_CLEAR_ITERATIONS 200
+
+// Returns the elapsed time (in seconds) since the specified counter value.
+static double ElapsedSeconds(LARGE_INTEGER start)
+{
+    LARGE_INTEGER end, freq;
+    QueryPerformanceCounter(&end);
+    QueryPerformanceFrequency(&freq);
+    return (double)(end.QuadPart - start.QuadPart) / (double)freq.QuadPart;
+}
+
+// Prints the bandwidth of 'r8ClearFrameBuffer' (in GB/s) compared to 'memset' with the same number of bytes.
+static void BenchmarkClear(R8uint width, R8uint height)
+{
+    const size_t numBytes = (size_t)width * height * (sizeof(R8ColorBuffer) + sizeof(R8DepthBuffer));
+
+    R8object benchFrameBuffer = r8CreateFrameBuffer(width, height);
+    unsigned char* buffer = (unsigned char*)malloc(numBytes);
+
+    // Warm up (first touch of the memory pages)
+    r8ClearFrameBuffer(benchFrameBuffer, 0.0f, R8_COLOR_BUFFER_BIT | R8_DEPTH_BUFFER_BIT);
+    memset(buffer, 0, numBytes);
+
+    LARGE_INTEGER start;
+    QueryPerformanceCounter(&start);
+
+    for (int i = 0; i < BENCHMARK_CLEAR_ITERATIONS; ++i)
+        r8ClearFrameBuffer(benchFrameBuffer, 0.0f, R8_COLOR_BUFFER_BIT | R8_DEPTH_BUFFER_BIT);
+
+    double clearTime = ElapsedSeconds(start);
+
+    QueryPerformanceCounter(&start);
+
+    for (int i = 0; i < BENCHMARK_CLEAR_ITERATIONS; ++i)
+        memset(buffer, i, numBytes);
+
+    double memsetTime = ElapsedSeconds(start);
+
+    const double numGigaBytes = (double)numBytes * BENCHMARK_CLEAR_ITERATIONS / 1.0e9;
+
+    printf(
+        "clear %ux%u (%i threads): r8ClearFrameBuffer = %.2f GB/s, memset = %.2f GB/s (checksum %i)\n",
+        width, height, r8GetIntegerv(R8_THREAD_COUNT), numGigaBytes / clearTime, numGigaBytes / memsetTime, (int)buffer[numBytes / 2]
+    );
+
+    free(buffer);
+    r8DeleteFrameBuffer(benchFrameBuffer);
+}
+
+#endif
+
 
 // --- functions --- //
 
@@ -268,6 +325,11 @@ int main()
     frameBuffer = r8CreateFrameBuffer(screenWidth, screenHeight);
     r8BindFrameBuffer(frameBuffer);
 
+    #ifdef BENCHMARK_CLEAR
+    BenchmarkClear(screenWidth, screenHeight);
+    BenchmarkClear(3840, 2160);
+    #endif
+
     // Create textures
     #ifdef R8_COLOR_BUFFER_24BIT
     const R8boolean dither = R8_FALSE;
@@ -554,13 +616,17 @@ int main()
             r8DrawIndexed(R8_TRIANGLES, NUM_INDICES, 0);
 
             #if 1
+            // Draw the other cubes as instances
+            float instanceMatrices[8][16];
+
             for (int i = 1; i < 9; ++i)
             {
-                worldMatrix[12] = ((float)(i % 3))*5*size[0];
-                worldMatrix[14] = ((float)(i / 3))*5*size[2];
-                r8WorldMatrix(worldMatrix);
-                r8DrawIndexed(R8_TRIANGLES, NUM_INDICES, 0);
+                memcpy(instanceMatrices[i - 1], worldMatrix, sizeof(worldMatrix));
+                instanceMatrices[i - 1][12] = ((float)(i % 3))*5*size[0];
+                instanceMatrices[i - 1][14] = ((float)(i / 3))*5*size[2];
             }
+
+            r8DrawIndexedInstanced(R8_TRIANGLES, NUM_INDICES, 0, 8, &(instanceMatrices[0][0]));
             #endif
 
             // Draw floor
@@ -96,33 +96,33 @@ void r8_context_present(R8Context* context, const R8FrameBuffer* framebuffer)
     }
 
     // Get iterators
-    const R8uint num = context->width*context->height;
-
     R8Color* dst = context->colors;
-    R8Color* dstEnd = dst + num;
 
-    const R8Pixel* pixels = framebuffer->pixels;
     const R8Color* palette = context->colorPalette->colors;
 
     #ifndef R8_COLOR_BUFFER_24BIT
     const R8Color* paletteColor;
     #endif
 
-    // Iterate over all pixels
-    while (dst != dstEnd)
+    // Iterate over all pixels (this also converts the tiled layout of the frame buffer into rows)
+    for (R8int y = 0; y < (R8int)context->height; ++y)
     {
-        #ifdef R8_COLOR_BUFFER_24BIT
-        *dst = pixels->colorIndex;
-        #else
-        paletteColor = (palette + pixels->colorIndex);
-
-        dst->r = paletteColor->r;
-        dst->g = paletteColor->g;
-        dst->b = paletteColor->b;
-        #endif
-
-        ++dst;
-        ++pixels;
+        for (R8int x = 0; x < (R8int)context->width; ++x)
+        {
+            const R8ColorBuffer colorIndex = R8_FRAMEBUFFER_COLOR(framebuffer, r8_framebuffer_index(framebuffer, x, y));
+
+            #ifdef R8_COLOR_BUFFER_24BIT
+            *dst = colorIndex;
+            #else
+            paletteColor = (palette + colorIndex);
+
+            dst->r = paletteColor->r;
+            dst->g = paletteColor->g;
+            dst->b = paletteColor->b;
+            #endif
+
+            ++dst;
+        }
     }
 
     // Show framebuffer on device context ('SetDIBits' only needs a device context when 'DIB_PAL_COLORS' is used)
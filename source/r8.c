@@ -11,12 +11,15 @@
 #include "r8_framebuffer.h"
 #include "r8_vertexbuffer.h"
 #include "r8_indexbuffer.h"
+#include "r8_meshlet.h"
+#include "r8_mesh.h"
 #include "r8_texture.h"
 #include "r8_image.h"
 #include "r8_state_machine.h"
 #include "r8_global_state.h"
 #include "r8_renderer.h"
 #include "r8_memory.h"
+#include "r8_tile_binner.h"
 
 #include <string.h>
 
@@ -64,16 +67,63 @@ const char* r8GetString(R8enum str)
     return NULL;
 }
 
+static R8int _get_frame_statistic(R8enum param)
+{
+    R8FrameBuffer* frameBuffer = R8_STATE_MACHINE.boundFrameBuffer;
+
+    if (frameBuffer == NULL)
+    {
+        R8_ERROR(R8_ERROR_INVALID_STATE);
+        return 0;
+    }
+
+    // Binned polygons must be rasterized first
+    r8_tile_binner_flush();
+
+    switch (param)
+    {
+        case R8_HIZ_REJECTED_SPANS:
+            return frameBuffer->hizRejectedSpans;
+        case R8_HIZ_REJECTED_PIXELS:
+            return frameBuffer->hizRejectedPixels;
+        case R8_VERTEX_CACHE_HITS:
+            return frameBuffer->vertexCacheHits;
+        case R8_VERTEX_CACHE_MISSES:
+            return frameBuffer->vertexCacheMisses;
+        case R8_CULLED_DRAWS:
+            return frameBuffer->culledDraws;
+        case R8_CULLED_MESHLETS:
+            return frameBuffer->culledMeshlets;
+    }
+    return 0;
+}
+
 R8int r8GetIntegerv(R8enum param)
 {
     switch (param)
     {
         case R8_MAX_TEXTURE_SIZE:
             return R8_MAX_TEX_SIZE;
+        case R8_THREAD_COUNT:
+            return r8_tile_binner_get_thread_count();
+        case R8_MAX_THREAD_COUNT:
+            return R8_MAX_NUM_THREADS;
+        case R8_HIZ_REJECTED_SPANS:
+        case R8_HIZ_REJECTED_PIXELS:
+        case R8_VERTEX_CACHE_HITS:
+        case R8_VERTEX_CACHE_MISSES:
+        case R8_CULLED_DRAWS:
+        case R8_CULLED_MESHLETS:
+            return _get_frame_statistic(param);
     }
     return 0;
 }
 
+void r8SetThreadCount(R8int threadCount)
+{
+    r8_tile_binner_set_thread_count(threadCount);
+}
+
 // --- context --- //
 
 R8object r8CreateContext(const R8contextdesc* desc, R8uint width, R8uint height)
@@ -93,6 +143,12 @@ void r8MakeCurrent(R8object context)
 
 void r8Present(R8object context)
 {
+    r8_tile_binner_flush();
+
+    // Tiles which have not been rasterized still have to be cleared
+    if (R8_STATE_MACHINE.boundFrameBuffer != NULL)
+        r8_framebuffer_resolve(R8_STATE_MACHINE.boundFrameBuffer, NULL);
+
     r8_context_present((R8Context*)context, R8_STATE_MACHINE.boundFrameBuffer);
 }
 
@@ -105,17 +161,35 @@ R8object r8CreateFrameBuffer(R8uint width, R8uint height)
 
 void r8DeleteFrameBuffer(R8object frameBuffer)
 {
+    r8_tile_binner_flush();
     r8_framebuffer_delete((R8FrameBuffer*)frameBuffer);
 }
 
 void r8BindFrameBuffer(R8object frameBuffer)
 {
+    r8_tile_binner_flush();
     r8_state_machine_bind_framebuffer((R8FrameBuffer*)frameBuffer);
 }
 
 void r8ClearFrameBuffer(R8object frameBuffer, R8float clearDepth, R8bitfield clearFlags)
 {
-    r8_framebuffer_clear((R8FrameBuffer*)frameBuffer, clearDepth, clearFlags);
+    r8_tile_binner_flush();
+
+    if (R8_STATE_MACHINE.states[R8_SCISSOR] != R8_FALSE && frameBuffer != NULL)
+    {
+        // Only clear the area inside the scissor rectangle
+        R8Rect rect;
+        r8_state_machine_scissor_rect((R8FrameBuffer*)frameBuffer, &rect);
+        r8_framebuffer_clear((R8FrameBuffer*)frameBuffer, &rect, clearDepth, clearFlags);
+    }
+    else
+        r8_framebuffer_clear((R8FrameBuffer*)frameBuffer, NULL, clearDepth, clearFlags);
+}
+
+void r8InvalidateFrameBuffer(R8object frameBuffer, R8float clearDepth, R8bitfield clearFlags)
+{
+    r8_tile_binner_flush();
+    r8_framebuffer_invalidate((R8FrameBuffer*)frameBuffer, clearDepth, clearFlags);
 }
 
 // --- texture --- //
@@ -127,6 +201,7 @@ R8object r8CreateTexture()
 
 void r8DeleteTexture(R8object texture)
 {
+    r8_tile_binner_flush();
     r8_texture_delete((R8Texture*)texture);
 }
 
@@ -139,6 +214,7 @@ void r8TexImage2D(
     R8object texture, R8texsize width, R8texsize height, R8enum format,
     const R8void* data, R8boolean dither, R8boolean generateMips)
 {
+    r8_tile_binner_flush();
     r8_texture_image2d((R8Texture*)texture, width, height, format, data, dither, generateMips);
 }
 
@@ -147,6 +223,8 @@ void r8TexImage2DFromFile(
 {
     R8Image* image = r8_image_load_from_file(filename);
 
+    r8_tile_binner_flush();
+
     r8_texture_image2d(
         (R8Texture*)texture,
         (R8texsize)(image->width),
@@ -211,7 +289,12 @@ void r8DeleteIndexBuffer(R8object indexBuffer)
 
 void r8IndexBufferData(R8object indexBuffer, const R8ushort* indices, R8sizei numIndices)
 {
-    r8_indexbuffer_data((R8IndexBuffer*)indexBuffer, indices, numIndices);
+    r8_indexbuffer_data((R8IndexBuffer*)indexBuffer, indices, R8_UNSIGNED_SHORT, numIndices);
+}
+
+void r8IndexBufferData32(R8object indexBuffer, const R8uint* indices, R8sizei numIndices)
+{
+    r8_indexbuffer_data((R8IndexBuffer*)indexBuffer, indices, R8_UNSIGNED_INT, numIndices);
 }
 
 void r8IndexBufferDataFromFile(R8object indexBuffer, R8sizei* numIndices, FILE* file)
@@ -224,6 +307,89 @@ void r8BindIndexBuffer(R8object indexBuffer)
     r8_state_machine_bind_indexbuffer((R8IndexBuffer*)indexBuffer);
 }
 
+void r8BuildMeshlets(R8object indexBuffer, R8object vertexBuffer)
+{
+    r8_meshlet_build((R8IndexBuffer*)indexBuffer, (const R8VertexBuffer*)vertexBuffer);
+}
+
+// --- mesh --- //
+
+R8object r8LoadMesh(const char* filename)
+{
+    return (R8object)r8_mesh_load(filename);
+}
+
+void r8DeleteMesh(R8object mesh)
+{
+    r8_mesh_delete((R8Mesh*)mesh);
+}
+
+R8boolean r8SaveMesh(const char* filename, R8object vertexBuffer, R8object indexBuffer)
+{
+    return r8_mesh_save(filename, (const R8VertexBuffer*)vertexBuffer, (const R8IndexBuffer*)indexBuffer);
+}
+
+R8object r8GetMeshVertexBuffer(R8object mesh)
+{
+    if (mesh == NULL)
+    {
+        R8_ERROR(R8_ERROR_NULL_POINTER);
+        return NULL;
+    }
+    return (R8object)((R8Mesh*)mesh)->vertexBuffer;
+}
+
+R8object r8GetMeshIndexBuffer(R8object mesh)
+{
+    if (mesh == NULL)
+    {
+        R8_ERROR(R8_ERROR_NULL_POINTER);
+        return NULL;
+    }
+    return (R8object)((R8Mesh*)mesh)->indexBuffer;
+}
+
+R8int r8GetMeshParameteri(R8object mesh, R8enum param)
+{
+    if (mesh == NULL)
+    {
+        R8_ERROR(R8_ERROR_NULL_POINTER);
+        return 0;
+    }
+
+    const R8Mesh* meshObj = (const R8Mesh*)mesh;
+
+    switch (param)
+    {
+        case R8_MESH_NUM_VERTICES:
+            return meshObj->vertexBuffer->numVertices;
+        case R8_MESH_NUM_INDICES:
+            return meshObj->indexBuffer->numIndices;
+        case R8_MESH_INDEX_TYPE:
+            return (R8int)meshObj->indexBuffer->indexType;
+        default:
+            R8_ERROR(R8_ERROR_INVALID_ARGUMENT);
+            return 0;
+    }
+}
+
+void r8GetMeshBounds(R8object mesh, R8float* boundsMin, R8float* boundsMax)
+{
+    if (mesh == NULL || boundsMin == NULL || boundsMax == NULL)
+    {
+        R8_ERROR(R8_ERROR_NULL_POINTER);
+        return;
+    }
+
+    const R8Mesh* meshObj = (const R8Mesh*)mesh;
+
+    for (R8int i = 0; i < 3; ++i)
+    {
+        boundsMin[i] = meshObj->boundsMin[i];
+        boundsMax[i] = meshObj->boundsMax[i];
+    }
+}
+
 // --- matrices --- //
 
 void r8ProjectionMatrix(const R8float* matrix4x4)
@@ -329,6 +495,8 @@ void r8ClearColor(R8ubyte r, R8ubyte g, R8ubyte b)
 
 void r8Color(R8ubyte r, R8ubyte g, R8ubyte b)
 {
+    r8_immediate_mode_flush();
+
     R8_STATE_MACHINE.color0 = r8_color_to_colorindex(r, g, b);
 }
 
@@ -347,7 +515,7 @@ void r8DrawScreenImage(R8int left, R8int top, R8int right, R8int bottom)
     r8_render_screenspace_image(left, top, right, bottom);
 }
 
-void r8Draw(R8enum priitives, R8ushort numVertices, R8ushort firstVertex)
+void r8Draw(R8enum priitives, R8sizei numVertices, R8sizei firstVertex)
 {
     switch (priitives)
     {
@@ -381,7 +549,7 @@ void r8Draw(R8enum priitives, R8ushort numVertices, R8ushort firstVertex)
     }
 }
 
-void r8DrawIndexed(R8enum priitives, R8ushort numVertices, R8ushort firstVertex)
+void r8DrawIndexed(R8enum priitives, R8sizei numVertices, R8sizei firstVertex)
 {
     switch (priitives)
     {
@@ -415,6 +583,32 @@ void r8DrawIndexed(R8enum priitives, R8ushort numVertices, R8ushort firstVertex)
     }
 }
 
+void r8DrawIndexedInstanced(R8enum priitives, R8sizei numVertices, R8sizei firstVertex, R8sizei numInstances, const R8float* worldMatrices)
+{
+    r8_render_indexed_instanced(
+        priitives,
+        numVertices,
+        firstVertex,
+        numInstances,
+        (const R8Matrix4*)worldMatrices,
+        R8_STATE_MACHINE.boundVertexBuffer,
+        R8_STATE_MACHINE.boundIndexBuffer
+    );
+}
+
+void r8MultiDrawIndexed(R8enum priitives, R8sizei numRanges, const R8sizei* firstVertices, const R8sizei* numVertices, const R8object* textures)
+{
+    r8_render_indexed_multi(
+        priitives,
+        numRanges,
+        firstVertices,
+        numVertices,
+        (const R8Texture* const*)textures,
+        R8_STATE_MACHINE.boundVertexBuffer,
+        R8_STATE_MACHINE.boundIndexBuffer
+    );
+}
+
 // --- immediate mode --- //
 
 void r8Begin(R8enum priitives)
@@ -0,0 +1,157 @@
+/*
+ * r8_bounds.c
+ *
+ * This file is part of the "R8" (Copyright(c) 2021 by Phani Srikar (Pikachuxxxx))
+ * See "LICENSE.txt" for license information.
+ */
+
+#include "r8_bounds.h"
+
+#include <math.h>
+#include <float.h>
+
+
+// --- internals --- //
+
+// Sets the plane to 'lhs - s * rhs' (both given as matrix rows) and normalizes its normal.
+static void _frustum_plane(R8float* plane, const R8float* lhs, const R8float* rhs, R8float s)
+{
+    for (R8int i = 0; i < 4; ++i)
+        plane[i] = lhs[i] - s * rhs[i];
+
+    const R8float len = sqrtf(plane[0]*plane[0] + plane[1]*plane[1] + plane[2]*plane[2]);
+
+    if (len > 0.0f)
+    {
+        for (R8int i = 0; i < 4; ++i)
+            plane[i] /= len;
+    }
+}
+
+R8_INLINE R8float _plane_distance(const R8float* plane, R8float x, R8float y, R8float z)
+{
+    return plane[0]*x + plane[1]*y + plane[2]*z + plane[3];
+}
+
+// --- interface --- //
+
+void r8_bounds_from_streams(R8Bounds* bounds, const R8float* const* coords, R8sizei numVertices)
+{
+    if (numVertices <= 0)
+    {
+        const R8float zero[3] = { 0.0f, 0.0f, 0.0f };
+        r8_bounds_from_box(bounds, zero, zero);
+        return;
+    }
+
+    // Compute bounding box
+    for (R8int c = 0; c < 3; ++c)
+    {
+        R8float minValue = FLT_MAX, maxValue = -FLT_MAX;
+
+        for (R8sizei i = 0; i < numVertices; ++i)
+        {
+            const R8float x = coords[c][i];
+            if (minValue > x)
+                minValue = x;
+            if (maxValue < x)
+                maxValue = x;
+        }
+
+        bounds->min[c] = minValue;
+        bounds->max[c] = maxValue;
+        bounds->center[c] = (minValue + maxValue) * 0.5f;
+    }
+
+    // Sphere around the box center, which encloses all vertices (mostly tighter than the sphere around the box)
+    R8float maxDistSq = 0.0f;
+
+    for (R8sizei i = 0; i < numVertices; ++i)
+    {
+        const R8float dx = coords[0][i] - bounds->center[0];
+        const R8float dy = coords[1][i] - bounds->center[1];
+        const R8float dz = coords[2][i] - bounds->center[2];
+        const R8float distSq = dx*dx + dy*dy + dz*dz;
+
+        if (maxDistSq < distSq)
+            maxDistSq = distSq;
+    }
+
+    bounds->radius = sqrtf(maxDistSq);
+}
+
+void r8_bounds_from_box(R8Bounds* bounds, const R8float* min, const R8float* max)
+{
+    R8float distSq = 0.0f;
+
+    for (R8int c = 0; c < 3; ++c)
+    {
+        bounds->min[c] = min[c];
+        bounds->max[c] = max[c];
+        bounds->center[c] = (min[c] + max[c]) * 0.5f;
+
+        const R8float halfSize = (max[c] - min[c]) * 0.5f;
+        distSq += halfSize*halfSize;
+    }
+
+    bounds->radius = sqrtf(distSq);
+}
+
+void r8_frustum_setup(R8Frustum* frustum, const R8Matrix4* worldViewProjectionMatrix, const R8float* clipBounds)
+{
+    // Get matrix rows, so a clip space component is the dot product of its row with (x, y, z, 1)
+    R8float rows[4][4];
+
+    for (R8int r = 0; r < 4; ++r)
+    {
+        for (R8int c = 0; c < 4; ++c)
+            rows[r][c] = worldViewProjectionMatrix->m[c][r];
+    }
+
+    const R8float zero[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+    R8float negRow0[4], negRow1[4];
+
+    for (R8int c = 0; c < 4; ++c)
+    {
+        negRow0[c] = -rows[0][c];
+        negRow1[c] = -rows[1][c];
+    }
+
+    _frustum_plane(frustum->planes[0], rows[0], rows[3], clipBounds[0]);    // x >= minX * w
+    _frustum_plane(frustum->planes[1], negRow0, rows[3], -clipBounds[1]);   // x <= maxX * w
+    _frustum_plane(frustum->planes[2], rows[1], rows[3], clipBounds[2]);    // y >= minY * w
+    _frustum_plane(frustum->planes[3], negRow1, rows[3], -clipBounds[3]);   // y <= maxY * w
+    _frustum_plane(frustum->planes[4], rows[2], zero, 0.0f);                // z >= 0
+    _frustum_plane(frustum->planes[5], rows[3], rows[2], 1.0f);             // z <= w
+}
+
+R8boolean r8_frustum_cull_sphere(const R8Frustum* frustum, const R8float* center, R8float radius)
+{
+    for (R8int i = 0; i < 6; ++i)
+    {
+        if (_plane_distance(frustum->planes[i], center[0], center[1], center[2]) < -radius)
+            return R8_TRUE;
+    }
+    return R8_FALSE;
+}
+
+R8boolean r8_frustum_cull_bounds(const R8Frustum* frustum, const R8Bounds* bounds)
+{
+    if (r8_frustum_cull_sphere(frustum, bounds->center, bounds->radius))
+        return R8_TRUE;
+
+    // Test the box corner which is farthest along each plane normal
+    for (R8int i = 0; i < 6; ++i)
+    {
+        const R8float* plane = frustum->planes[i];
+
+        const R8float x = (plane[0] >= 0.0f ? bounds->max[0] : bounds->min[0]);
+        const R8float y = (plane[1] >= 0.0f ? bounds->max[1] : bounds->min[1]);
+        const R8float z = (plane[2] >= 0.0f ? bounds->max[2] : bounds->min[2]);
+
+        if (_plane_distance(plane, x, y, z) < 0.0f)
+            return R8_TRUE;
+    }
+
+    return R8_FALSE;
+}
@@ -0,0 +1,53 @@
+/*
+ * r8_bounds.h
+ *
+ * This file is part of the "R8" (Copyright(c) 2021 by Phani Srikar (Pikachuxxxx))
+ * See "LICENSE.txt" for license information.
+ */
+
+#ifndef R8_BOUNDS_H
+#define R8_BOUNDS_H
+
+
+#include "r8_types.h"
+#include "r8_matrix4.h"
+
+
+//! Bounding volume of a set of vertices in object space.
+typedef struct R8Bounds
+{
+    R8float min[3];     // Minimum of the axis-aligned bounding box.
+    R8float max[3];     // Maximum of the axis-aligned bounding box.
+    R8float center[3];  // Center of the bounding sphere (which is the center of the box).
+    R8float radius;     // Radius of the bounding sphere.
+}
+R8Bounds;
+
+//! View volume in object space, given by six planes (left, right, top, bottom, near, far) with normalized normals.
+typedef struct R8Frustum
+{
+    R8float planes[6][4];   // Plane equations (a, b, c, d). A point p is inside if a*p.x + b*p.y + c*p.z + d >= 0.
+}
+R8Frustum;
+
+
+// Computes the bounding box and a bounding sphere of the vertices from the coordinate streams (X, Y, Z).
+void r8_bounds_from_streams(R8Bounds* bounds, const R8float* const* coords, R8sizei numVertices);
+
+// Computes the bounding volume from a bounding box only (the sphere encloses the box), so no vertex has to be read.
+void r8_bounds_from_box(R8Bounds* bounds, const R8float* min, const R8float* max);
+
+/*
+Extracts the view volume from the world-view-projection matrix. The x and y planes enclose the clipping rectangle
+in normalized device coordinates 'clipBounds' (min X, max X, min Y, max Y) and the z planes are 0 <= z <= w (see the clipping in the renderer).
+*/
+void r8_frustum_setup(R8Frustum* frustum, const R8Matrix4* worldViewProjectionMatrix, const R8float* clipBounds);
+
+// Returns R8_TRUE if the sphere is entirely outside of the view volume.
+R8boolean r8_frustum_cull_sphere(const R8Frustum* frustum, const R8float* center, R8float radius);
+
+// Returns R8_TRUE if the bounding volume is entirely outside of the view volume (tests the sphere first, then the box).
+R8boolean r8_frustum_cull_bounds(const R8Frustum* frustum, const R8Bounds* bounds);
+
+
+#endif
@@ -36,18 +36,53 @@
 /// Use perspective corrected depth and texture coordinates
 #define R8_PERSPECTIVE_CORRECTED
 
+/// Number of pixels between two perspective corrected texture coordinates along a scanline (they are interpolated linearly in between, 1 = correct each pixel)
+#define R8_PERSPECTIVE_SPAN_SIZE    16
+
+/// Maximal relative change of the depth interpolant along a scanline, for which the texture coordinates are interpolated linearly along the entire scanline
+#define R8_PERSPECTIVE_TOLERANCE    R8_FLOAT(0.01)
+
+/// Number of entries in the direct-mapped post-transform vertex cache for indexed triangles (must be a power of two)
+#define R8_VERTEX_CACHE_SIZE        64
+
+/// Maximal number of vertices which are transformed in one batch (bounds the memory of the per-draw clip stream; must be a multiple of 3 and 8).
+#define R8_MAX_BATCH_VERTICES       (1024*24)
+
+/// Maximal number of instances whose world-view-projection matrices are combined in one batch (see r8DrawIndexedInstanced).
+#define R8_MAX_BATCH_INSTANCES      64
+
+/// Width (in pixels) of the guard band around the clipping rectangle. Polygons inside the guard band are not clipped geometrically,
+/// instead the rasterizers clamp their spans to the clipping rectangle (0 = clip all polygons which cross the clipping rectangle).
+#define R8_GUARD_BAND_SIZE          2048
+
 /// Use an 8-bit depth buffer (instead of 16 bit)
 //#define R8_DEPTH_BUFFER_8BIT
 
-/// Use a 64-bit interpolation type instead of 32-bit
-#define R8_INTERP_64BIT
+/// Use a 64-bit interpolation type instead of 32-bit (interpolants are restarted per scanline and relative to each triangle, so 32-bit is accurate enough)
+//#define R8_INTERP_64BIT
 
-/// Merge color- and depth buffers to a single one inside a frame buffer.
-#define R8_MERGE_COLOR_AND_DEPTH_BUFFERS //CAN NOT BE DISABLED YET!
+/// Merge color- and depth buffers to a single one inside a frame buffer (otherwise they are stored in separate, tightly packed planes).
+//#define R8_MERGE_COLOR_AND_DEPTH_BUFFERS
+
+/// Store the pixels of a frame buffer in 8x8 tiles with Morton order (instead of row-major order), which keeps vertical and rotated primitives cache friendly.
+//#define R8_TILED_FRAMEBUFFER
 
 /// Makes all pixels with color black a transparent pixel.
 #define R8_BLACK_IS_ALPHA
 
+/// Use SSE2/AVX2 intrinsics if the compiler supports them.
+#define R8_ENABLE_SIMD
+
+
+#ifdef R8_ENABLE_SIMD
+#   if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#       define R8_SSE2
+#   endif
+#   if defined(__AVX2__)
+#       define R8_AVX2
+#   endif
+#endif
+
 
 #ifdef R8_INTERP_64BIT
 /// 64-bit interpolation type.
@@ -10,10 +10,426 @@
 #include "r8_memory.h"
 #include "r8_state_machine.h"
 #include "r8_color_palette.h"
+#include "r8_external_math.h"
+#include "r8_tile_binner.h"
 
 #include <stdlib.h>
 #include <string.h>
+#include <math.h>
 
+#ifdef R8_SSE2
+#   include <emmintrin.h>
+#endif
+
+
+// --- internals --- //
+
+/// Parameters to clear a rectangle of a frame buffer.
+typedef struct R8ClearJob
+{
+    R8FrameBuffer*  frameBuffer;
+    R8Rect          rect;       // Clamped clear rectangle (inclusive).
+    R8uint          firstBand;  // Band index of the first row in the clear rectangle.
+    R8bitfield      clearFlags;
+    R8ColorBuffer   color;
+    R8DepthBuffer   depth;      // Depth value which is stored in the depth buffer.
+    R8DepthBuffer   hizDepth;   // Depth value in the depth range of the current frame.
+    R8boolean       streaming;  // Use non-temporal stores which bypass the cache.
+    #ifdef R8_MERGE_COLOR_AND_DEPTH_BUFFERS
+    R8uint          pixelPattern;
+    #else
+    R8uint          colorPattern;
+    R8uint          depthPattern;
+    #endif
+}
+R8ClearJob;
+
+// Returns the number of bytes which are written per pixel with the specified clear flags.
+static R8uint _get_clear_pixel_size(R8bitfield clearFlags)
+{
+    #ifdef R8_MERGE_COLOR_AND_DEPTH_BUFFERS
+    return sizeof(R8Pixel);
+    #else
+    R8uint size = 0;
+    if ((clearFlags & R8_COLOR_BUFFER_BIT) != 0)
+        size += sizeof(R8ColorBuffer);
+    if ((clearFlags & R8_DEPTH_BUFFER_BIT) != 0)
+        size += sizeof(R8DepthBuffer);
+    return size;
+    #endif
+}
+
+// Returns the specified element (1, 2 or 4 bytes) repeated to a 32-bit pattern.
+static R8uint _get_fill_pattern(const R8void* element, R8uint size)
+{
+    R8ubyte bytes[4];
+    R8uint pattern;
+
+    for (R8uint i = 0; i < 4; i += size)
+        memcpy(bytes + i, element, size);
+
+    memcpy(&pattern, bytes, 4);
+    return pattern;
+}
+
+/**
+Fills 'count' elements of 'size' bytes (1, 2 or 4) with the specified 32-bit pattern.
+The destination must be aligned to the element size. Whole cache lines are written with SSE2 stores.
+*/
+static void _fill_elements(R8void* dst, R8uint size, R8uint count, R8uint pattern, R8boolean streaming)
+{
+    R8ubyte* ptr = (R8ubyte*)dst;
+    R8ubyte* end = ptr + size*count;
+
+    #ifdef R8_SSE2
+
+    // Fill head until the destination is aligned to 16 bytes
+    while (ptr != end && ((size_t)ptr & 15) != 0)
+    {
+        memcpy(ptr, &pattern, size);
+        ptr += size;
+    }
+
+    // Fill 64 bytes (one cache line) per iteration
+    const __m128i value = _mm_set1_epi32((int)pattern);
+    R8ubyte* lineEnd = ptr + ((size_t)(end - ptr) & ~(size_t)63);
+
+    if (streaming)
+    {
+        for (; ptr != lineEnd; ptr += 64)
+        {
+            _mm_stream_si128((__m128i*)(ptr     ), value);
+            _mm_stream_si128((__m128i*)(ptr + 16), value);
+            _mm_stream_si128((__m128i*)(ptr + 32), value);
+            _mm_stream_si128((__m128i*)(ptr + 48), value);
+        }
+    }
+    else
+    {
+        for (; ptr != lineEnd; ptr += 64)
+        {
+            _mm_store_si128((__m128i*)(ptr     ), value);
+            _mm_store_si128((__m128i*)(ptr + 16), value);
+            _mm_store_si128((__m128i*)(ptr + 32), value);
+            _mm_store_si128((__m128i*)(ptr + 48), value);
+        }
+    }
+
+    // Fill remaining 16 byte blocks
+    for (; end - ptr >= 16; ptr += 16)
+        _mm_store_si128((__m128i*)ptr, value);
+
+    #else
+
+    if (size == 1)
+    {
+        memset(ptr, (R8ubyte)pattern, count);
+        return;
+    }
+
+    // Fill head until the destination is aligned to 4 bytes
+    while (ptr != end && ((size_t)ptr & 3) != 0)
+    {
+        memcpy(ptr, &pattern, size);
+        ptr += size;
+    }
+
+    for (; end - ptr >= 4; ptr += 4)
+        *((R8uint*)ptr) = pattern;
+
+    #endif
+
+    // Fill tail
+    while (ptr != end)
+    {
+        memcpy(ptr, &pattern, size);
+        ptr += size;
+    }
+}
+
+// Resets all Hi-Z tiles in the specified tile rows which are overlapped by the clear rectangle.
+static void _clear_hiz_tiles(const R8ClearJob* job, R8int tileTop, R8int tileBottom)
+{
+    R8FrameBuffer* frameBuffer = job->frameBuffer;
+    const R8Rect* rect = &(job->rect);
+
+    const R8int width = (R8int)frameBuffer->width;
+    const R8int height = (R8int)frameBuffer->height;
+    const R8int lastTileX = (R8int)frameBuffer->hizWidth - 1;
+    const R8int lastTileY = (R8int)frameBuffer->hizHeight - 1;
+
+    const R8int tileLeft = rect->left >> R8_HIZ_TILE_SHIFT;
+    const R8int tileRight = rect->right >> R8_HIZ_TILE_SHIFT;
+
+    // Determine range of tiles which are entirely cleared (tiles at the frame buffer border can be smaller)
+    const R8int fullLeft = (rect->left + R8_HIZ_TILE_SIZE - 1) >> R8_HIZ_TILE_SHIFT;
+    const R8int fullTop = (rect->top + R8_HIZ_TILE_SIZE - 1) >> R8_HIZ_TILE_SHIFT;
+    const R8int fullRight = (rect->right == width - 1 ? lastTileX : ((rect->right + 1) >> R8_HIZ_TILE_SHIFT) - 1);
+    const R8int fullBottom = (rect->bottom == height - 1 ? lastTileY : ((rect->bottom + 1) >> R8_HIZ_TILE_SHIFT) - 1);
+
+    R8HiZTile clearedTile;
+    clearedTile.minDepth    = job->hizDepth;
+    clearedTile.dirty       = R8_FALSE;
+
+    for (R8int tileY = tileTop; tileY <= tileBottom; ++tileY)
+    {
+        R8HiZTile* tiles = &(frameBuffer->hizTiles[tileY * (lastTileX + 1)]);
+
+        if (tileY < fullTop || tileY > fullBottom)
+        {
+            // Tiles are only partially cleared, so they must be computed again
+            for (R8int tileX = tileLeft; tileX <= tileRight; ++tileX)
+                tiles[tileX].dirty = R8_TRUE;
+            continue;
+        }
+
+        const R8int tileHeight = R8_MIN(R8_HIZ_TILE_SIZE, height - (tileY << R8_HIZ_TILE_SHIFT));
+
+        for (R8int tileX = tileLeft; tileX < fullLeft; ++tileX)
+            tiles[tileX].dirty = R8_TRUE;
+        for (R8int tileX = fullRight + 1; tileX <= tileRight; ++tileX)
+            tiles[tileX].dirty = R8_TRUE;
+
+        if (fullLeft <= fullRight)
+        {
+            clearedTile.minCount = (R8ushort)(R8_HIZ_TILE_SIZE * tileHeight);
+
+            for (R8int tileX = fullLeft; tileX <= fullRight; ++tileX)
+                tiles[tileX] = clearedTile;
+
+            if (fullRight == lastTileX)
+                tiles[fullRight].minCount = (R8ushort)((width - (fullRight << R8_HIZ_TILE_SHIFT)) * tileHeight);
+        }
+    }
+}
+
+// Clears 'count' consecutive pixels in memory, beginning at the specified pixel index.
+static void _clear_span(const R8ClearJob* job, R8uint offset, R8uint count)
+{
+    R8FrameBuffer* frameBuffer = job->frameBuffer;
+
+    const R8boolean clearColor = ((job->clearFlags & R8_COLOR_BUFFER_BIT) != 0);
+    const R8boolean clearDepth = ((job->clearFlags & R8_DEPTH_BUFFER_BIT) != 0);
+
+    #ifdef R8_MERGE_COLOR_AND_DEPTH_BUFFERS
+
+    R8Pixel* dst = frameBuffer->pixels + offset;
+    R8Pixel* dstEnd = dst + count;
+
+    if (clearColor && clearDepth)
+        _fill_elements(dst, sizeof(R8Pixel), count, job->pixelPattern, job->streaming);
+    else if (clearColor)
+    {
+        for (; dst != dstEnd; ++dst)
+            dst->colorIndex = job->color;
+    }
+    else
+    {
+        for (; dst != dstEnd; ++dst)
+            dst->depth = job->depth;
+    }
+
+    #else
+
+    // Each plane is only touched if it's cleared
+    if (clearColor)
+        _fill_elements(frameBuffer->colors + offset, sizeof(R8ColorBuffer), count, job->colorPattern, job->streaming);
+    if (clearDepth)
+        _fill_elements(frameBuffer->depths + offset, sizeof(R8DepthBuffer), count, job->depthPattern, job->streaming);
+
+    #endif
+}
+
+#ifdef R8_TILED_FRAMEBUFFER
+
+// Clears each pixel of the specified rectangle (inclusive) separately.
+static void _clear_tiled_pixels(const R8ClearJob* job, R8int left, R8int top, R8int right, R8int bottom)
+{
+    for (R8int y = top; y <= bottom; ++y)
+    {
+        for (R8int x = left; x <= right; ++x)
+            _clear_span(job, (R8uint)r8_framebuffer_index(job->frameBuffer, x, y), 1);
+    }
+}
+
+/**
+Clears the specified rows inside the clear rectangle with the tiled layout.
+Tiles which are entirely cleared are contiguous in memory (the padding at the frame buffer border is cleared, too),
+so they are cleared as a single span. Only the tiles at the border of the clear rectangle are cleared pixel by pixel.
+*/
+static void _clear_rows(const R8ClearJob* job, R8int top, R8int bottom)
+{
+    const R8FrameBuffer* frameBuffer = job->frameBuffer;
+    const R8Rect* rect = &(job->rect);
+
+    const R8int lastTileX = (R8int)frameBuffer->hizWidth - 1;
+    const R8int fullLeft = (rect->left + R8_HIZ_TILE_SIZE - 1) >> R8_HIZ_TILE_SHIFT;
+    const R8int fullRight = (rect->right == (R8int)frameBuffer->width - 1 ? lastTileX : ((rect->right + 1) >> R8_HIZ_TILE_SHIFT) - 1);
+
+    for (R8int tileY = top >> R8_HIZ_TILE_SHIFT; tileY <= (bottom >> R8_HIZ_TILE_SHIFT); ++tileY)
+    {
+        const R8int tileTop = tileY << R8_HIZ_TILE_SHIFT;
+        const R8int rowTop = R8_MAX(top, tileTop);
+        const R8int rowBottom = R8_MIN(bottom, tileTop + R8_HIZ_TILE_SIZE - 1);
+
+        const R8boolean fullRows = ( rowTop == tileTop &&
+                                     (rowBottom == tileTop + R8_HIZ_TILE_SIZE - 1 || rowBottom == (R8int)frameBuffer->height - 1) );
+
+        if (fullRows && fullLeft <= fullRight)
+        {
+            _clear_span(
+                job, (R8uint)r8_framebuffer_index(frameBuffer, fullLeft << R8_HIZ_TILE_SHIFT, tileTop),
+                (R8uint)(fullRight - fullLeft + 1) << (R8_HIZ_TILE_SHIFT*2)
+            );
+            _clear_tiled_pixels(job, rect->left, rowTop, (fullLeft << R8_HIZ_TILE_SHIFT) - 1, rowBottom);
+            _clear_tiled_pixels(job, (fullRight + 1) << R8_HIZ_TILE_SHIFT, rowTop, rect->right, rowBottom);
+        }
+        else
+            _clear_tiled_pixels(job, rect->left, rowTop, rect->right, rowBottom);
+    }
+}
+
+#else
+
+// Clears the specified rows inside the clear rectangle with the row-major layout.
+static void _clear_rows(const R8ClearJob* job, R8int top, R8int bottom)
+{
+    const R8uint pitch = job->frameBuffer->width;
+    R8uint width = (R8uint)(job->rect.right - job->rect.left + 1);
+    R8int numRows = bottom - top + 1;
+
+    if (width == pitch)
+    {
+        // Rows are contiguous in memory, so clear them as a single row
+        width *= (R8uint)numRows;
+        numRows = 1;
+    }
+
+    for (R8int y = top; y < top + numRows; ++y)
+        _clear_span(job, y * pitch + (R8uint)job->rect.left, width);
+}
+
+#endif
+
+// Clears all rows of the specified band inside the clear rectangle.
+static void _clear_band(R8uint index, R8void* arg)
+{
+    const R8ClearJob* job = (const R8ClearJob*)arg;
+
+    const R8uint band = job->firstBand + index;
+    const R8int top = R8_MAX(job->rect.top, (R8int)(band * R8_CLEAR_BAND_HEIGHT));
+    const R8int bottom = R8_MIN(job->rect.bottom, (R8int)(band * R8_CLEAR_BAND_HEIGHT + R8_CLEAR_BAND_HEIGHT - 1));
+
+    _clear_rows(job, top, bottom);
+
+    #ifdef R8_SSE2
+    if (job->streaming)
+        _mm_sfence();
+    #endif
+
+    if ((job->clearFlags & R8_DEPTH_BUFFER_BIT) != 0)
+        _clear_hiz_tiles(job, top >> R8_HIZ_TILE_SHIFT, bottom >> R8_HIZ_TILE_SHIFT);
+}
+
+// Clears the specified rectangle, which must be clamped to the frame buffer. 'depth' must be in the depth range of the current frame.
+static void _clear_rect(
+    R8FrameBuffer* frameBuffer, const R8Rect* rect, R8ColorBuffer color, R8DepthBuffer depth, R8bitfield clearFlags, R8boolean parallel)
+{
+    R8ClearJob job;
+
+    job.frameBuffer = frameBuffer;
+    job.rect        = *rect;
+    job.clearFlags  = clearFlags;
+    job.color       = color;
+    job.depth       = (R8DepthBuffer)(depth ^ frameBuffer->depthMask);
+    job.hizDepth    = depth;
+
+    #ifdef R8_MERGE_COLOR_AND_DEPTH_BUFFERS
+    R8Pixel pixel;
+    memset(&pixel, 0, sizeof(pixel));
+    pixel.colorIndex    = job.color;
+    pixel.depth         = job.depth;
+    job.pixelPattern    = _get_fill_pattern(&pixel, sizeof(R8Pixel));
+    #else
+    job.colorPattern    = _get_fill_pattern(&(job.color), sizeof(R8ColorBuffer));
+    job.depthPattern    = _get_fill_pattern(&(job.depth), sizeof(R8DepthBuffer));
+    #endif
+
+    // Bypass the cache if the cleared memory would not fit into it anyway
+    const R8uint numPixels = (R8uint)(rect->right - rect->left + 1) * (R8uint)(rect->bottom - rect->top + 1);
+    job.streaming = (numPixels * _get_clear_pixel_size(clearFlags) >= R8_CLEAR_STREAMING_SIZE);
+
+    // Clear horizontal bands in parallel (each band covers entire rows of Hi-Z tiles)
+    const R8uint firstBand = (R8uint)rect->top / R8_CLEAR_BAND_HEIGHT;
+    const R8uint lastBand = (R8uint)rect->bottom / R8_CLEAR_BAND_HEIGHT;
+
+    job.firstBand = firstBand;
+
+    if (parallel && numPixels >= R8_CLEAR_PARALLEL_SIZE)
+        r8_tile_binner_parallel_for(lastBand - firstBand + 1, _clear_band, &job);
+    else
+    {
+        for (R8uint i = 0; i <= lastBand - firstBand; ++i)
+            _clear_band(i, &job);
+    }
+}
+
+// Resets the statistics which are collected since the last depth clear.
+static void _reset_statistics(R8FrameBuffer* frameBuffer)
+{
+    frameBuffer->hizRejectedSpans   = 0;
+    frameBuffer->hizRejectedPixels  = 0;
+    frameBuffer->vertexCacheHits    = 0;
+    frameBuffer->vertexCacheMisses  = 0;
+    frameBuffer->culledDraws        = 0;
+    frameBuffer->culledMeshlets     = 0;
+}
+
+// Removes the specified flags from all pending clears.
+static void _discard_pending_clears(R8FrameBuffer* frameBuffer, R8bitfield clearFlags)
+{
+    if ((frameBuffer->pendingClearFlags & clearFlags) != 0)
+    {
+        const R8uint numTiles = frameBuffer->clearWidth * frameBuffer->clearHeight;
+
+        for (R8uint i = 0; i < numTiles; ++i)
+            frameBuffer->clearTiles[i] &= (R8ubyte)(~clearFlags);
+
+        frameBuffer->pendingClearFlags &= ~clearFlags;
+    }
+}
+
+/**
+Prepares the depth range for the next frame before the entire depth buffer is cleared.
+Returns R8_TRUE if the depth buffer doesn't need to be cleared, because the frame-parity depth trick is active.
+Then all depth values of the previous frame are stored with inverted bits, so they are behind all depth values of the next frame.
+*/
+static R8boolean _begin_depth_frame(R8FrameBuffer* frameBuffer, R8float clearDepth)
+{
+    const R8boolean parity = R8_STATE_MACHINE.states[R8_DEPTH_PARITY];
+
+    if (parity && frameBuffer->depthParity && r8_pixel_write_depth(clearDepth) == 0)
+    {
+        frameBuffer->depthMask ^= R8_DEPTH_MAX;
+
+        // Farthest depth of each Hi-Z tile is unknown now
+        for (R8uint i = 0, n = frameBuffer->hizWidth*frameBuffer->hizHeight; i < n; ++i)
+            frameBuffer->hizTiles[i].dirty = R8_TRUE;
+
+        return R8_TRUE;
+    }
+
+    // Depth range can only be changed when the entire depth buffer is cleared
+    frameBuffer->depthParity    = parity;
+    frameBuffer->depthShift     = (parity ? 1 : 0);
+    frameBuffer->depthBias      = (parity ? R8_DEPTH_PARITY_BIAS : 0);
+    frameBuffer->depthMask      = 0;
+
+    return R8_FALSE;
+}
+
+
+// --- interface --- //
 
 R8FrameBuffer* r8_framebuffer_create(R8uint width, R8uint height)
 {
@@ -28,12 +444,55 @@ R8FrameBuffer* r8_framebuffer_create(R8uint width, R8uint height)
 
     frameBuffer->width = width;
     frameBuffer->height = height;
-    frameBuffer->pixels = R8_CALLOC(R8Pixel, width*height);
+    frameBuffer->hizWidth = (width + R8_HIZ_TILE_SIZE - 1) >> R8_HIZ_TILE_SHIFT;
+    frameBuffer->hizHeight = (height + R8_HIZ_TILE_SIZE - 1) >> R8_HIZ_TILE_SHIFT;
+
+    // Tiled layout stores entire tiles, also at the frame buffer border
+    #ifdef R8_TILED_FRAMEBUFFER
+    frameBuffer->numPixels = (frameBuffer->hizWidth*frameBuffer->hizHeight) << (R8_HIZ_TILE_SHIFT*2);
+    #else
+    frameBuffer->numPixels = width*height;
+    #endif
+
+    #ifdef R8_MERGE_COLOR_AND_DEPTH_BUFFERS
+    frameBuffer->pixels = R8_CALLOC(R8Pixel, frameBuffer->numPixels);
+    #else
+    frameBuffer->colors = R8_CALLOC(R8ColorBuffer, frameBuffer->numPixels);
+    frameBuffer->depths = R8_CALLOC(R8DepthBuffer, frameBuffer->numPixels);
+    #endif
     frameBuffer->scanlinesStart = R8_CALLOC(R8ScalineSide, height);
     frameBuffer->scanlinesEnd = R8_CALLOC(R8ScalineSide, height);
 
+    // Create hierarchical depth buffer
+    frameBuffer->hizTiles = R8_CALLOC(R8HiZTile, frameBuffer->hizWidth*frameBuffer->hizHeight);
+
+    _reset_statistics(frameBuffer);
+
+    // Create pending clear flags
+    frameBuffer->clearWidth = (width + R8_CLEAR_TILE_SIZE - 1) / R8_CLEAR_TILE_SIZE;
+    frameBuffer->clearHeight = (height + R8_CLEAR_TILE_SIZE - 1) / R8_CLEAR_TILE_SIZE;
+    frameBuffer->clearTiles = R8_CALLOC(R8ubyte, frameBuffer->clearWidth*frameBuffer->clearHeight);
+    frameBuffer->pendingClearFlags = 0;
+    frameBuffer->pendingClearColor = 0;
+    frameBuffer->pendingClearDepth = 0.0f;
+
+    // Use entire depth range until the frame-parity depth trick is enabled
+    frameBuffer->depthParity = R8_FALSE;
+    frameBuffer->depthShift = 0;
+    frameBuffer->depthBias = 0;
+    frameBuffer->depthMask = 0;
+
     // Initialize framebuffer
-    memset(frameBuffer->pixels, 0, width*height*sizeof(R8Pixel));
+    #ifdef R8_MERGE_COLOR_AND_DEPTH_BUFFERS
+    memset(frameBuffer->pixels, 0, frameBuffer->numPixels*sizeof(R8Pixel));
+    #else
+    memset(frameBuffer->colors, 0, frameBuffer->numPixels*sizeof(R8ColorBuffer));
+    memset(frameBuffer->depths, 0, frameBuffer->numPixels*sizeof(R8DepthBuffer));
+    #endif
+
+    // Hi-Z tiles will be computed on first use
+    for (R8uint i = 0; i < frameBuffer->hizWidth*frameBuffer->hizHeight; ++i)
+        frameBuffer->hizTiles[i].dirty = R8_TRUE;
 
     r8_ref_add(frameBuffer);
 
@@ -46,55 +505,193 @@ void r8_framebuffer_delete(R8FrameBuffer* frameBuffer)
     {
         r8_ref_release(frameBuffer);
 
+        #ifdef R8_MERGE_COLOR_AND_DEPTH_BUFFERS
         R8_FREE(frameBuffer->pixels);
+        #else
+        R8_FREE(frameBuffer->colors);
+        R8_FREE(frameBuffer->depths);
+        #endif
         R8_FREE(frameBuffer->scanlinesStart);
         R8_FREE(frameBuffer->scanlinesEnd);
+        R8_FREE(frameBuffer->hizTiles);
+        R8_FREE(frameBuffer->clearTiles);
         R8_FREE(frameBuffer);
     }
 }
 
-void r8_framebuffer_clear(R8FrameBuffer* frameBuffer, R8float clearDepth, R8bitfield clearFlags)
+void r8_framebuffer_clear(R8FrameBuffer* frameBuffer, const R8Rect* rect, R8float clearDepth, R8bitfield clearFlags)
 {
-    if (frameBuffer != NULL && frameBuffer->pixels != NULL)
+    if (frameBuffer == NULL)
+    {
+        r8_error_set(R8_ERROR_NULL_POINTER, __FUNCTION__);
+        return;
+    }
+
+    clearFlags &= (R8_COLOR_BUFFER_BIT | R8_DEPTH_BUFFER_BIT);
+
+    // Clamp clear rectangle to the frame buffer
+    R8Rect area;
+
+    if (rect != NULL)
+    {
+        area.left   = R8_MAX(rect->left, 0);
+        area.top    = R8_MAX(rect->top, 0);
+        area.right  = R8_MIN(rect->right, (R8int)frameBuffer->width - 1);
+        area.bottom = R8_MIN(rect->bottom, (R8int)frameBuffer->height - 1);
+    }
+    else
     {
-        // Convert depth (32-bit) into pixel depth (16-bit or 8-bit)
-        R8DepthBuffer depth = r8_pixel_write_depth(clearDepth);
+        area.left   = 0;
+        area.top    = 0;
+        area.right  = (R8int)frameBuffer->width - 1;
+        area.bottom = (R8int)frameBuffer->height - 1;
+    }
 
-        // Get clear color from state machine (and optionally its color index)
-        R8ColorBuffer clearColor = R8_STATE_MACHINE.clearColor;
+    if (clearFlags == 0 || area.left > area.right || area.top > area.bottom)
+        return;
 
-        // Iterate over the entire framebuffer
-        R8Pixel* dst = frameBuffer->pixels;
-        R8Pixel* dstEnd = dst + (frameBuffer->width * frameBuffer->height);
+    if ((clearFlags & R8_DEPTH_BUFFER_BIT) != 0)
+        _reset_statistics(frameBuffer);
 
-        if ((clearFlags & R8_COLOR_BUFFER_BIT) != 0 && (clearFlags & R8_DEPTH_BUFFER_BIT) != 0)
-        {
-            while (dst != dstEnd)
-            {
-                dst->colorIndex = clearColor;
-                dst->depth      = depth;
-                ++dst;
-            }
-        }
-        else if ((clearFlags & R8_COLOR_BUFFER_BIT) != 0)
+    const R8boolean entire = ( area.left == 0 && area.right == (R8int)frameBuffer->width - 1 &&
+                               area.top == 0 && area.bottom == (R8int)frameBuffer->height - 1 );
+
+    if (entire)
+    {
+        // Depth buffer doesn't need to be cleared if the frame-parity depth trick is active
+        if ((clearFlags & R8_DEPTH_BUFFER_BIT) != 0 && _begin_depth_frame(frameBuffer, clearDepth))
+            clearFlags &= ~R8_DEPTH_BUFFER_BIT;
+
+        // Pending clears are overwritten anyway
+        _discard_pending_clears(frameBuffer, clearFlags);
+    }
+    else
+    {
+        // Pending clears must be applied before their tiles are partially overwritten
+        r8_framebuffer_resolve(frameBuffer, &area);
+    }
+
+    if (clearFlags != 0)
+    {
+        // Convert depth (32-bit) into pixel depth (16-bit or 8-bit) and get clear color from state machine
+        _clear_rect(
+            frameBuffer, &area, R8_STATE_MACHINE.clearColor,
+            r8_framebuffer_frame_depth(frameBuffer, r8_pixel_write_depth(clearDepth)), clearFlags, R8_TRUE
+        );
+    }
+}
+
+void r8_framebuffer_invalidate(R8FrameBuffer* frameBuffer, R8float clearDepth, R8bitfield clearFlags)
+{
+    if (frameBuffer == NULL)
+    {
+        r8_error_set(R8_ERROR_NULL_POINTER, __FUNCTION__);
+        return;
+    }
+
+    clearFlags &= (R8_COLOR_BUFFER_BIT | R8_DEPTH_BUFFER_BIT);
+
+    if ((clearFlags & R8_DEPTH_BUFFER_BIT) != 0)
+    {
+        _reset_statistics(frameBuffer);
+
+        // Depth buffer doesn't need to be cleared if the frame-parity depth trick is active
+        if (_begin_depth_frame(frameBuffer, clearDepth))
+            clearFlags &= ~R8_DEPTH_BUFFER_BIT;
+        else
+            frameBuffer->pendingClearDepth = clearDepth;
+    }
+
+    if (clearFlags == 0)
+        return;
+
+    if ((clearFlags & R8_COLOR_BUFFER_BIT) != 0)
+        frameBuffer->pendingClearColor = R8_STATE_MACHINE.clearColor;
+
+    // Mark all tiles as pending (clear values of other pending flags remain unchanged)
+    const R8uint numTiles = frameBuffer->clearWidth * frameBuffer->clearHeight;
+
+    for (R8uint i = 0; i < numTiles; ++i)
+        frameBuffer->clearTiles[i] |= (R8ubyte)clearFlags;
+
+    frameBuffer->pendingClearFlags |= clearFlags;
+}
+
+void r8_framebuffer_resolve_tiles(R8FrameBuffer* frameBuffer, const R8Rect* rect)
+{
+    R8int tileLeft = 0, tileTop = 0;
+    R8int tileRight = (R8int)frameBuffer->clearWidth - 1;
+    R8int tileBottom = (R8int)frameBuffer->clearHeight - 1;
+
+    if (rect != NULL)
+    {
+        // Get range of overlapped tiles
+        R8_CLAMP_LARGEST(tileLeft, rect->left / R8_CLEAR_TILE_SIZE);
+        R8_CLAMP_LARGEST(tileTop, rect->top / R8_CLEAR_TILE_SIZE);
+        R8_CLAMP_SMALLEST(tileRight, rect->right / R8_CLEAR_TILE_SIZE);
+        R8_CLAMP_SMALLEST(tileBottom, rect->bottom / R8_CLEAR_TILE_SIZE);
+    }
+
+    const R8DepthBuffer depth = r8_framebuffer_frame_depth(frameBuffer, r8_pixel_write_depth(frameBuffer->pendingClearDepth));
+
+    for (R8int tileY = tileTop; tileY <= tileBottom; ++tileY)
+    {
+        for (R8int tileX = tileLeft; tileX <= tileRight; ++tileX)
         {
-            while (dst != dstEnd)
+            R8ubyte* clearFlags = &(frameBuffer->clearTiles[tileY * frameBuffer->clearWidth + tileX]);
+
+            if (*clearFlags != 0)
             {
-                dst->colorIndex = clearColor;
-                ++dst;
+                R8Rect area;
+                area.left   = tileX * R8_CLEAR_TILE_SIZE;
+                area.top    = tileY * R8_CLEAR_TILE_SIZE;
+                area.right  = R8_MIN(area.left + R8_CLEAR_TILE_SIZE, (R8int)frameBuffer->width) - 1;
+                area.bottom = R8_MIN(area.top + R8_CLEAR_TILE_SIZE, (R8int)frameBuffer->height) - 1;
+
+                _clear_rect(frameBuffer, &area, frameBuffer->pendingClearColor, depth, *clearFlags, R8_FALSE);
+
+                *clearFlags = 0;
             }
         }
-        else if ((clearFlags & R8_DEPTH_BUFFER_BIT) != 0)
+    }
+
+    if (rect == NULL)
+        frameBuffer->pendingClearFlags = 0;
+}
+
+void r8_framebuffer_hiz_refresh(R8FrameBuffer* frameBuffer, R8uint tileX, R8uint tileY)
+{
+    // Get tile area (clamped at the frame buffer border)
+    const R8uint left = tileX << R8_HIZ_TILE_SHIFT;
+    const R8uint top = tileY << R8_HIZ_TILE_SHIFT;
+    const R8uint right = R8_MIN(left + R8_HIZ_TILE_SIZE, frameBuffer->width);
+    const R8uint bottom = R8_MIN(top + R8_HIZ_TILE_SIZE, frameBuffer->height);
+
+    // Find farthest depth value and count how many pixels have it
+    R8DepthBuffer minDepth = R8_DEPTH_MAX;
+    R8ushort minCount = 0;
+
+    for (R8uint y = top; y < bottom; ++y)
+    {
+        for (R8uint x = left; x < right; ++x)
         {
-            while (dst != dstEnd)
+            const R8DepthBuffer depth = r8_framebuffer_read_depth(frameBuffer, r8_framebuffer_index(frameBuffer, (R8int)x, (R8int)y));
+
+            if (minDepth > depth)
             {
-                dst->depth = depth;
-                ++dst;
+                minDepth = depth;
+                minCount = 1;
             }
+            else if (minDepth == depth)
+                ++minCount;
         }
     }
-    else
-        r8_error_set(R8_ERROR_NULL_POINTER, __FUNCTION__);
+
+    R8HiZTile* tile = &(frameBuffer->hizTiles[tileY * frameBuffer->hizWidth + tileX]);
+
+    tile->minDepth  = minDepth;
+    tile->minCount  = minCount;
+    tile->dirty     = R8_FALSE;
 }
 
 void r8_framebuffer_setup_scanlines(
@@ -103,9 +700,19 @@ void r8_framebuffer_setup_scanlines(
     R8int pitch = (R8int)frameBuffer->width;
     R8int len = end.y - start.y;
 
+    // Polygons inside the guard band can exceed the frame buffer, but only rows inside of it have scanline sides
+    const R8int height = (R8int)frameBuffer->height;
+
     if (len <= 0)
     {
+        if (start.y < 0 || start.y >= height)
+            return;
+
+        // Also store interpolants, otherwise they are left over from the r8evious polygon
         sides[start.y].offset = start.y * pitch + start.x;
+        sides[start.y].z = start.z;
+        sides[start.y].u = start.u;
+        sides[start.y].v = start.v;
         return;
     }
 
@@ -118,22 +725,23 @@ void r8_framebuffer_setup_scanlines(
     R8interp uStep       = (end.u - start.u) / len;
     R8interp vStep       = (end.v - start.v) / len;
 
-    // Fill scanline sides
-    R8ScalineSide* sidesEnd = &(sides[end.y]);
+    // Fill scanline sides (interpolants are computed from the start vertex for each row, so rounding errors don't accumulate)
+    const R8int first = R8_MAX(0, -start.y);
+    const R8int last = R8_MIN(len, height - 1 - start.y);
+
+    sides += start.y + first;
+    offsetStart += offsetStep * first;
 
-    for (sides += start.y; sides <= sidesEnd; ++sides)
+    for (R8int i = first; i <= last; ++i, ++sides)
     {
-        // Setup scanline side
-        sides->offset = (R8int)(offsetStart + 0.5);
-        sides->z = start.z;
-        sides->u = start.u;
-        sides->v = start.v;
+        // Setup scanline side (round down, because the offset is negative left of the first pixel)
+        sides->offset = (R8int)floor(offsetStart + 0.5);
+        sides->z = start.z + zStep * i;
+        sides->u = start.u + uStep * i;
+        sides->v = start.v + vStep * i;
 
         // Next step
         offsetStart += offsetStep;
-        start.z += zStep;
-        start.u += uStep;
-        start.v += vStep;
     }
 }
 
@@ -12,6 +12,27 @@
 #include "r8_pixel.h"
 #include "r8_macros.h"
 #include "r8_raster_vertex.h"
+#include "r8_rect.h"
+
+
+// Width and height (in pixels) of a tile in the hierarchical depth buffer
+#define R8_HIZ_TILE_SIZE    8
+#define R8_HIZ_TILE_SHIFT   3
+
+// Number of rows which are cleared by a single thread (must be a multiple of the Hi-Z tile size)
+#define R8_CLEAR_BAND_HEIGHT    (R8_HIZ_TILE_SIZE*2)
+
+// Minimal number of pixels to clear the frame buffer with multiple threads
+#define R8_CLEAR_PARALLEL_SIZE  (256*256)
+
+// Minimal number of bytes to clear the frame buffer with non-temporal stores, which bypass the cache
+#define R8_CLEAR_STREAMING_SIZE (8*1024*1024)
+
+// Width and height (in pixels) of a tile with its own pending clear flags (must be a multiple of the Hi-Z tile size)
+#define R8_CLEAR_TILE_SIZE      64
+
+// Bit which is set for all depth values of the current frame, if the frame-parity depth trick is enabled
+#define R8_DEPTH_PARITY_BIAS    ((R8_DEPTH_MAX >> 1) + 1)
 
 
 /// Raster scanline side structure
@@ -24,40 +45,164 @@ typedef struct R8ScalineSide
 }
 R8ScalineSide;
 
+/// Tile of the hierarchical depth buffer (Hi-Z)
+typedef struct R8HiZTile
+{
+    R8DepthBuffer   minDepth;   // Farthest depth value inside the tile. Pixels with depth not greater than this are occluded.
+    R8ushort        minCount;   // Number of pixels inside the tile whose depth is equal to 'minDepth'.
+    R8boolean       dirty;      // All pixels with depth 'minDepth' have been overwritten, so it must be computed again.
+}
+R8HiZTile;
+
 /// Framebuffer structure
 typedef struct R8FrameBuffer
 {
     R8uint              width;
     R8uint              height;
+    R8uint              numPixels;          // Number of pixels in each plane (including the padding of the tiled layout)
     #ifdef R8_MERGE_COLOR_AND_DEPTH_BUFFERS
-    R8Pixel*           pixels;
+    R8Pixel*            pixels;
     #else
-    R8ubyte*            colors;
-    R8DepthBuffer         depths;
+    R8ColorBuffer*      colors;             // Tightly packed color plane
+    R8DepthBuffer*      depths;             // Tightly packed depth plane
     #endif
     R8ScalineSide* scanlinesStart; // Start offsets to scanlines
     R8ScalineSide* scanlinesEnd;   // End offsets to scanlines
+    R8HiZTile*          hizTiles;           // Coarse depth buffer with one entry for each tile
+    R8uint              hizWidth;           // Number of Hi-Z tiles in X direction
+    R8uint              hizHeight;          // Number of Hi-Z tiles in Y direction
+    volatile R8int      hizRejectedSpans;   // Number of spans rejected by the Hi-Z test since the last depth clear
+    volatile R8int      hizRejectedPixels;  // Number of pixels rejected by the Hi-Z test since the last depth clear
+    R8int               vertexCacheHits;    // Number of indexed vertices found in the post-transform vertex cache since the last depth clear
+    R8int               vertexCacheMisses;  // Number of indexed vertices which had to be transformed since the last depth clear
+    R8int               culledDraws;        // Number of draw calls which have been culled by their bounding volume since the last depth clear
+    R8int               culledMeshlets;     // Number of meshlets which have been culled by their bounding sphere or normal cone since the last depth clear
+    R8ubyte*            clearTiles;         // Pending clear flags (R8_COLOR_BUFFER_BIT and R8_DEPTH_BUFFER_BIT) for each clear tile
+    R8uint              clearWidth;         // Number of clear tiles in X direction
+    R8uint              clearHeight;        // Number of clear tiles in Y direction
+    R8bitfield          pendingClearFlags;  // Combination of all pending clear flags. Zero if no tile must be cleared.
+    R8ColorBuffer       pendingClearColor;  // Color index for the pending color clears
+    R8float             pendingClearDepth;  // Depth value for the pending depth clears
+    R8boolean           depthParity;        // Frame-parity depth trick is active (see R8_DEPTH_PARITY)
+    R8DepthBuffer       depthShift;         // Shift to fit depth values into the depth range of the current frame
+    R8DepthBuffer       depthBias;          // Bias to move depth values into the depth range of the current frame
+    R8DepthBuffer       depthMask;          // XOR mask between the stored depth values and the ones of the current frame
 }
 R8FrameBuffer;
 
 
+/// Accesses the color index and depth value of the pixel with the specified linear index (can be used as l-values).
+#ifdef R8_MERGE_COLOR_AND_DEPTH_BUFFERS
+#   define R8_FRAMEBUFFER_COLOR(frameBuffer, index) ((frameBuffer)->pixels[index].colorIndex)
+#   define R8_FRAMEBUFFER_DEPTH(frameBuffer, index) ((frameBuffer)->pixels[index].depth)
+#else
+#   define R8_FRAMEBUFFER_COLOR(frameBuffer, index) ((frameBuffer)->colors[index])
+#   define R8_FRAMEBUFFER_DEPTH(frameBuffer, index) ((frameBuffer)->depths[index])
+#endif
+
+
 R8FrameBuffer* r8_framebuffer_create(R8uint width, R8uint height);
 void r8_framebuffer_delete(R8FrameBuffer* frameBuffer);
 
-void r8_framebuffer_clear(R8FrameBuffer* frameBuffer, R8float clearDepth, R8bitfield clearFlags);
+/**
+Clears the specified rectangle (inclusive) of the frame buffer, or the entire frame buffer if 'rect' is null.
+Large areas are cleared in bands by the rasterizer threads.
+*/
+void r8_framebuffer_clear(R8FrameBuffer* frameBuffer, const R8Rect* rect, R8float clearDepth, R8bitfield clearFlags);
+
+/**
+Marks all clear tiles of the frame buffer as pending, without touching any pixel.
+The clear is applied to each tile the first time it's accessed (see r8_framebuffer_resolve).
+*/
+void r8_framebuffer_invalidate(R8FrameBuffer* frameBuffer, R8float clearDepth, R8bitfield clearFlags);
+
+/// Applies the pending clears of all tiles which overlap the specified rectangle (inclusive), or of all tiles if 'rect' is null.
+void r8_framebuffer_resolve_tiles(R8FrameBuffer* frameBuffer, const R8Rect* rect);
+
+/**
+Applies the pending clears of all tiles which overlap the specified rectangle (inclusive), or of all tiles if 'rect' is null.
+This must be called before any pixel inside the rectangle is read or written.
+*/
+R8_INLINE void r8_framebuffer_resolve(R8FrameBuffer* frameBuffer, const R8Rect* rect)
+{
+    if (frameBuffer->pendingClearFlags != 0)
+        r8_framebuffer_resolve_tiles(frameBuffer, rect);
+}
+
+/// Interleaves the bits of the specified 3-bit coordinates (Morton order inside a tile of the tiled layout).
+R8_INLINE R8int r8_framebuffer_morton(R8int x, R8int y)
+{
+    return ((x & 1) | ((x & 2) << 1) | ((x & 4) << 2) | ((y & 1) << 1) | ((y & 2) << 2) | ((y & 4) << 3));
+}
+
+/**
+Returns the index of the pixel at the specified coordinate inside the color and depth planes.
+With R8_TILED_FRAMEBUFFER the pixels are stored in tiles of the Hi-Z tile size (8x8), which are in Morton order internally.
+*/
+R8_INLINE R8int r8_framebuffer_index(const R8FrameBuffer* frameBuffer, R8int x, R8int y)
+{
+    #ifdef R8_TILED_FRAMEBUFFER
+    const R8int tile = (y >> R8_HIZ_TILE_SHIFT) * (R8int)frameBuffer->hizWidth + (x >> R8_HIZ_TILE_SHIFT);
+    return (tile << (R8_HIZ_TILE_SHIFT*2)) | r8_framebuffer_morton(x & (R8_HIZ_TILE_SIZE - 1), y & (R8_HIZ_TILE_SIZE - 1));
+    #else
+    return y * (R8int)frameBuffer->width + x;
+    #endif
+}
+
+/// Converts the specified pixel depth into the depth range of the current frame.
+R8_INLINE R8DepthBuffer r8_framebuffer_frame_depth(const R8FrameBuffer* frameBuffer, R8DepthBuffer depth)
+{
+    return (R8DepthBuffer)((depth >> frameBuffer->depthShift) | frameBuffer->depthBias);
+}
+
+/// Returns the depth value of the pixel with the specified linear index (in the depth range of the current frame).
+R8_INLINE R8DepthBuffer r8_framebuffer_read_depth(const R8FrameBuffer* frameBuffer, R8int index)
+{
+    return (R8DepthBuffer)(R8_FRAMEBUFFER_DEPTH(frameBuffer, index) ^ frameBuffer->depthMask);
+}
+
+/// Writes the depth value (in the depth range of the current frame) of the pixel with the specified linear index.
+R8_INLINE void r8_framebuffer_write_depth(R8FrameBuffer* frameBuffer, R8int index, R8DepthBuffer depth)
+{
+    R8_FRAMEBUFFER_DEPTH(frameBuffer, index) = (R8DepthBuffer)(depth ^ frameBuffer->depthMask);
+}
 
 /// Sets the start and end offsets of the specified scanlines.
 void r8_framebuffer_setup_scanlines(
     R8FrameBuffer* frameBuffer, R8ScalineSide* sides, R8RasterVertex start, R8RasterVertex end
 );
 
+/// Computes the farthest depth value of the specified Hi-Z tile from its pixels.
+void r8_framebuffer_hiz_refresh(R8FrameBuffer* frameBuffer, R8uint tileX, R8uint tileY);
+
+/// Returns the Hi-Z tile which contains the specified pixel.
+R8_INLINE R8HiZTile* r8_framebuffer_hiz_tile(R8FrameBuffer* frameBuffer, R8uint x, R8uint y)
+{
+    return &(frameBuffer->hizTiles[(y >> R8_HIZ_TILE_SHIFT) * frameBuffer->hizWidth + (x >> R8_HIZ_TILE_SHIFT)]);
+}
+
+/// Returns R8_TRUE if pixels with the specified (nearest) depth are occluded inside the Hi-Z tile of the specified pixel.
+R8_INLINE R8boolean r8_framebuffer_hiz_occluded(R8FrameBuffer* frameBuffer, R8uint x, R8uint y, R8DepthBuffer depth)
+{
+    R8HiZTile* tile = r8_framebuffer_hiz_tile(frameBuffer, x, y);
+    if (tile->dirty)
+        r8_framebuffer_hiz_refresh(frameBuffer, x >> R8_HIZ_TILE_SHIFT, y >> R8_HIZ_TILE_SHIFT);
+    return (depth < tile->minDepth);
+}
+
+/**
+Updates the Hi-Z tile before a pixel with the specified old depth value is overwritten.
+The tile only gets dirty when the last pixel with its farthest depth is overwritten.
+*/
+R8_INLINE void r8_framebuffer_hiz_write(R8HiZTile* tile, R8DepthBuffer oldDepth)
+{
+    if (oldDepth == tile->minDepth && --tile->minCount == 0)
+        tile->dirty = R8_TRUE;
+}
+
 R8_INLINE void r8_framebuffer_plot(R8FrameBuffer* frameBuffer, R8uint x, R8uint y, R8ColorBuffer colorIndex)
 {
-    #ifdef R8_MERGE_COLOR_AND_DEPTH_BUFFERS
-    frameBuffer->pixels[y * frameBuffer->width + x].colorIndex = colorIndex;
-    #else
-    frameBuffer->colors[y * frameBuffer->width + x] = colorIndex;
-    #endif
+    R8_FRAMEBUFFER_COLOR(frameBuffer, r8_framebuffer_index(frameBuffer, (R8int)x, (R8int)y)) = colorIndex;
 }
 
 
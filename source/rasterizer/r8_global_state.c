@@ -9,70 +9,250 @@
 #include "r8_config.h"
 #include "r8_error.h"
 #include "r8_renderer.h"
+#include "r8_tile_binner.h"
+#include "r8_external_math.h"
+
+#include <string.h>
 
 
 r8_global_state globalState_;
 
-#define _IMM_VERTICES   globalState_.immModeVertexBuffer.vertices
-#define _IMM_CUR_VERTEX _IMM_VERTICES[globalState_.immModeVertCounter]
+#define _IMM_VERTICES           globalState_.immModeVertexBuffer
+#define _IMM_CUR_COORD(c)       _IMM_VERTICES.coords[c][globalState_.immModeVertCounter]
+#define _IMM_CUR_TEXCOORD(c)    _IMM_VERTICES.texCoords[c][globalState_.immModeVertCounter]
 
 
 void r8_global_state_init()
 {
     r8_texture_singular_init(&(globalState_.singularTexture));
+    memset(&(globalState_.clipStream), 0, sizeof(R8ClipStream));
 
     // Initialize immediate mode
     r8_vertexbuffer_singular_init(&(globalState_.immModeVertexBuffer), R8_NUM_IMMEDIATE_VERTICES);
     globalState_.immModeActive      = R8_FALSE;
     globalState_.immModeVertCounter = 0;
     globalState_.immModePrimitives  = R8_POINTS;
+    globalState_.immModeLoopSplit   = R8_FALSE;
+    globalState_.immModeStripOdd    = R8_FALSE;
+
+    // Initialize sort-middle rasterizer (single threaded by default)
+    r8_tile_binner_init();
 }
 
 void r8_global_state_release()
 {
+    r8_tile_binner_release();
+
     r8_texture_singular_clear(&(globalState_.singularTexture));
     r8_vertexbuffer_singular_clear(&(globalState_.immModeVertexBuffer));
+    r8_clipstream_release(&(globalState_.clipStream));
 }
 
-static void _immediate_mode_flush()
+static void _immediate_mode_draw(R8sizei numVertices, R8sizei firstVertex, R8enum priitives)
 {
-    if (globalState_.immModeVertCounter == 0)
-        return;
+    const R8VertexBuffer* vertexBuffer = &(globalState_.immModeVertexBuffer);
 
-    // Draw current vertex buffer
-    switch (globalState_.immModePrimitives)
+    switch (priitives)
     {
         case R8_POINTS:
-            r8_render_points(globalState_.immModeVertCounter, 0, &(globalState_.immModeVertexBuffer));
+            r8_render_points(numVertices, firstVertex, vertexBuffer);
             break;
 
         case R8_LINES:
-            r8_render_lines(globalState_.immModeVertCounter, 0, &(globalState_.immModeVertexBuffer));
+            r8_render_lines(numVertices, firstVertex, vertexBuffer);
             break;
         case R8_LINE_STRIP:
-            r8_render_line_strip(globalState_.immModeVertCounter, 0, &(globalState_.immModeVertexBuffer));
+            r8_render_line_strip(numVertices, firstVertex, vertexBuffer);
             break;
         case R8_LINE_LOOP:
-            r8_render_line_loop(globalState_.immModeVertCounter, 0, &(globalState_.immModeVertexBuffer));
+            r8_render_line_loop(numVertices, firstVertex, vertexBuffer);
             break;
 
         case R8_TRIANGLES:
-            r8_render_triangles(globalState_.immModeVertCounter, 0, &(globalState_.immModeVertexBuffer));
+            r8_render_triangles(numVertices, firstVertex, vertexBuffer);
             break;
         case R8_TRIANGLE_STRIP:
-            r8_render_triangle_strip(globalState_.immModeVertCounter, 0, &(globalState_.immModeVertexBuffer));
+            r8_render_triangle_strip(numVertices, firstVertex, vertexBuffer);
             break;
         case R8_TRIANGLE_FAN:
-            r8_render_triangle_fan(globalState_.immModeVertCounter, 0, &(globalState_.immModeVertexBuffer));
+            r8_render_triangle_fan(numVertices, firstVertex, vertexBuffer);
             break;
 
         default:
             R8_ERROR(R8_ERROR_INVALID_ARGUMENT);
             break;
     }
+}
 
-    // Reset vertex counter
-    globalState_.immModeVertCounter = 0;
+static void _immediate_mode_copy_vertex(R8sizei dst, R8sizei src)
+{
+    for (R8int i = 0; i < 4; ++i)
+        _IMM_VERTICES.coords[i][dst] = _IMM_VERTICES.coords[i][src];
+    for (R8int i = 0; i < 2; ++i)
+        _IMM_VERTICES.texCoords[i][dst] = _IMM_VERTICES.texCoords[i][src];
+}
+
+static void _immediate_mode_swap_vertices(R8sizei a, R8sizei b)
+{
+    for (R8int i = 0; i < 4; ++i)
+        R8_SWAP(R8float, _IMM_VERTICES.coords[i][a], _IMM_VERTICES.coords[i][b]);
+    for (R8int i = 0; i < 2; ++i)
+        R8_SWAP(R8float, _IMM_VERTICES.texCoords[i][a], _IMM_VERTICES.texCoords[i][b]);
+}
+
+// Moves 'numKeep' vertices (starting at 'first') to the front of the buffer, which then only contains these vertices.
+static void _immediate_mode_keep_vertices(R8sizei first, R8sizei numKeep)
+{
+    const R8sizei next = globalState_.immModeVertCounter;
+
+    if (first > 0)
+    {
+        for (R8sizei i = 0; i < numKeep; ++i)
+            _immediate_mode_copy_vertex(i, first + i);
+    }
+
+    // Keep the texture coordinate of the next vertex, which may already have been specified (unless the buffer is full)
+    if (next != numKeep && next < _IMM_VERTICES.numVertices)
+    {
+        _IMM_VERTICES.texCoords[0][numKeep] = _IMM_VERTICES.texCoords[0][next];
+        _IMM_VERTICES.texCoords[1][numKeep] = _IMM_VERTICES.texCoords[1][next];
+    }
+
+    globalState_.immModeVertCounter = numKeep;
+}
+
+/*
+Draws the vertices of the buffer. If the priitive is not finished yet ('primitiveEnd' is false),
+the vertices of incomplete priitives and the vertices which are shared with the next priitives are kept.
+*/
+static void _immediate_mode_flush(R8boolean primitiveEnd)
+{
+    const R8sizei n = globalState_.immModeVertCounter;
+
+    if (n == 0)
+        return;
+
+    switch (globalState_.immModePrimitives)
+    {
+        case R8_POINTS:
+            _immediate_mode_draw(n, 0, R8_POINTS);
+            _immediate_mode_keep_vertices(n, 0);
+            break;
+
+        case R8_LINES:
+        case R8_TRIANGLES:
+        {
+            // Keep the vertices of the incomplete priitive
+            const R8sizei numDraw = (globalState_.immModePrimitives == R8_LINES ? n - n % 2 : n - n % 3);
+            if (numDraw > 0)
+                _immediate_mode_draw(numDraw, 0, globalState_.immModePrimitives);
+            _immediate_mode_keep_vertices(numDraw, (primitiveEnd ? 0 : n - numDraw));
+        }
+        break;
+
+        case R8_LINE_STRIP:
+            // Keep the last vertex
+            if (n >= 2)
+            {
+                _immediate_mode_draw(n, 0, R8_LINE_STRIP);
+                _immediate_mode_keep_vertices(n - 1, (primitiveEnd ? 0 : 1));
+            }
+            else if (primitiveEnd)
+                _immediate_mode_keep_vertices(n, 0);
+            break;
+
+        case R8_LINE_LOOP:
+            if (!globalState_.immModeLoopSplit)
+            {
+                if (primitiveEnd)
+                {
+                    _immediate_mode_draw(n, 0, R8_LINE_LOOP);
+                    _immediate_mode_keep_vertices(n, 0);
+                }
+                else if (n >= 2)
+                {
+                    // Draw the loop as strip so far, and keep its first and last vertex
+                    _immediate_mode_draw(n, 0, R8_LINE_STRIP);
+                    _immediate_mode_copy_vertex(1, n - 1);
+                    _immediate_mode_keep_vertices(0, 2);
+                    globalState_.immModeLoopSplit = R8_TRUE;
+                }
+            }
+            else if (primitiveEnd)
+            {
+                // Close the loop with a copy of its first vertex (the buffer always has room for one more vertex)
+                _immediate_mode_copy_vertex(n, 0);
+                _immediate_mode_draw(n, 1, R8_LINE_STRIP);
+                _immediate_mode_keep_vertices(n, 0);
+            }
+            else if (n >= 3)
+            {
+                _immediate_mode_draw(n - 1, 1, R8_LINE_STRIP);
+                _immediate_mode_copy_vertex(1, n - 1);
+                _immediate_mode_keep_vertices(0, 2);
+            }
+            break;
+
+        case R8_TRIANGLE_STRIP:
+            if (n >= 3)
+            {
+                R8sizei first = 0;
+
+                if (globalState_.immModeStripOdd)
+                {
+                    /*
+                    The kept vertices have been swapped, because the strip continues with an odd triangle.
+                    Draw this triangle separately, then continue the strip from the second kept vertex with an even triangle.
+                    */
+                    _immediate_mode_draw(3, 0, R8_TRIANGLES);
+                    _immediate_mode_copy_vertex(1, 0);
+                    first = 1;
+                }
+
+                if (n - first >= 3)
+                    _immediate_mode_draw(n - first, first, R8_TRIANGLE_STRIP);
+
+                // Keep the last two vertices, and swap them if the next triangle is odd
+                globalState_.immModeStripOdd ^= ((n - 2) % 2 != 0);
+
+                if (primitiveEnd)
+                {
+                    _immediate_mode_keep_vertices(n, 0);
+                    globalState_.immModeStripOdd = R8_FALSE;
+                }
+                else
+                {
+                    _immediate_mode_keep_vertices(n - 2, 2);
+                    if (globalState_.immModeStripOdd)
+                        _immediate_mode_swap_vertices(0, 1);
+                }
+            }
+            else if (primitiveEnd)
+            {
+                _immediate_mode_keep_vertices(n, 0);
+                globalState_.immModeStripOdd = R8_FALSE;
+            }
+            break;
+
+        case R8_TRIANGLE_FAN:
+            if (primitiveEnd)
+            {
+                _immediate_mode_draw(n, 0, R8_TRIANGLE_FAN);
+                _immediate_mode_keep_vertices(n, 0);
+            }
+            else if (n >= 3)
+            {
+                // Keep the center and the last vertex
+                _immediate_mode_draw(n, 0, R8_TRIANGLE_FAN);
+                _immediate_mode_copy_vertex(1, n - 1);
+                _immediate_mode_keep_vertices(0, 2);
+            }
+            break;
+
+        default:
+            R8_ERROR(R8_ERROR_INVALID_ARGUMENT);
+            break;
+    }
 }
 
 void r8_immediate_mode_begin(R8enum priitives)
@@ -92,6 +272,8 @@ void r8_immediate_mode_begin(R8enum priitives)
     globalState_.immModeActive      = R8_TRUE;
     globalState_.immModePrimitives  = priitives;
     globalState_.immModeVertCounter = 0;
+    globalState_.immModeLoopSplit   = R8_FALSE;
+    globalState_.immModeStripOdd    = R8_FALSE;
 }
 
 void r8_immediate_mode_end()
@@ -103,42 +285,41 @@ void r8_immediate_mode_end()
     }
 
     // Draw vertex buffer with current r8eviously selected priitive
-    _immediate_mode_flush();
+    _immediate_mode_flush(R8_TRUE);
 
     globalState_.immModeActive = R8_FALSE;
 }
 
+void r8_immediate_mode_flush()
+{
+    if (globalState_.immModeActive)
+        _immediate_mode_flush(R8_FALSE);
+}
+
 void r8_immediate_mode_texcoord(R8float u, R8float v)
 {
     // Store texture coordinate for current vertex
-    _IMM_CUR_VERTEX.texCoord.x = u;
-    _IMM_CUR_VERTEX.texCoord.y = v;
+    _IMM_CUR_TEXCOORD(0) = u;
+    _IMM_CUR_TEXCOORD(1) = v;
 }
 
 void r8_immediate_mode_vertex(R8float x, R8float y, R8float z, R8float w)
 {
     // Store vertex coordinate for current vertex
-    _IMM_CUR_VERTEX.coord.x = x;
-    _IMM_CUR_VERTEX.coord.y = y;
-    _IMM_CUR_VERTEX.coord.z = z;
-    _IMM_CUR_VERTEX.coord.w = w;
+    _IMM_CUR_COORD(0) = x;
+    _IMM_CUR_COORD(1) = y;
+    _IMM_CUR_COORD(2) = z;
+    _IMM_CUR_COORD(3) = w;
 
     // Count to next vertex
     ++globalState_.immModeVertCounter;
 
-    // Check if limit is exceeded
-    if (globalState_.immModeVertCounter >= R8_NUM_IMMEDIATE_VERTICES)
-        _immediate_mode_flush();
-
-    switch (globalState_.immModePrimitives)
+    // Grow the buffer until the limit is reached, then draw all complete priitives
+    if (globalState_.immModeVertCounter >= _IMM_VERTICES.numVertices)
     {
-        case R8_TRIANGLES:
-            if ( globalState_.immModeVertCounter + 3 >= R8_NUM_IMMEDIATE_VERTICES &&
-                 globalState_.immModeVertCounter % 3 == 0 )
-            {
-                _immediate_mode_flush();
-            }
-            break;
+        if (_IMM_VERTICES.numVertices < R8_MAX_IMMEDIATE_VERTICES)
+            r8_vertexbuffer_singular_grow(&(_IMM_VERTICES), R8_MIN(_IMM_VERTICES.numVertices * 2, R8_MAX_IMMEDIATE_VERTICES));
+        else
+            _immediate_mode_flush(R8_FALSE);
     }
 }
-
@@ -15,21 +15,27 @@
 
 #define R8_SINGULAR_TEXTURE         globalState_.singularTexture
 #define R8_SINGULAR_VERTEXBUFFER    globalState_.singularVertexBuffer
+#define R8_CLIP_STREAM              globalState_.clipStream
 
-// Number of vertices for the vertex buffer of the immediate draw mode (r8Begin/r8End)
+// Initial number of vertices for the vertex buffer of the immediate draw mode (r8Begin/r8End)
 #define R8_NUM_IMMEDIATE_VERTICES   32
+// Maximal number of vertices the immediate vertex buffer grows to, before its vertices are drawn in the middle of a primitive
+#define R8_MAX_IMMEDIATE_VERTICES   65536
 
 
 typedef struct r8_global_state
 {
     R8Texture      singularTexture;        // Texture with single color
     R8VertexBuffer singularVertexBuffer;
+    R8ClipStream   clipStream;             // Scratch stream for the transformed vertices of the current draw call
 
     // Immediate mode
     R8VertexBuffer immModeVertexBuffer;
     R8boolean       immModeActive;
     R8sizei         immModeVertCounter;
     R8enum          immModePrimitives;
+    R8boolean       immModeLoopSplit;       // Line loop has already been flushed (vertex 0 is kept as first vertex of the loop)
+    R8boolean       immModeStripOdd;        // Triangle strip continues with an odd triangle (the two kept vertices are swapped)
 }
 r8_global_state;
 
@@ -44,6 +50,12 @@ void r8_global_state_release();
 void r8_immediate_mode_begin(R8enum priitives);
 void r8_immediate_mode_end();
 
+/*
+Draws the pending vertices of the immediate mode before a state change, so the new state only affects subsequent vertices.
+Vertices which are shared with the next priitives (e.g. the last two vertices of a triangle strip) are kept.
+*/
+void r8_immediate_mode_flush();
+
 void r8_immediate_mode_texcoord(R8float u, R8float v);
 void r8_immediate_mode_vertex(R8float x, R8float y, R8float z, R8float w);
 
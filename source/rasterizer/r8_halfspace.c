@@ -0,0 +1,446 @@
+/*
+ * r8_halfspace.c
+ *
+ * This file is part of the "R8" (Copyright(c) 2021 by Phani Srikar (Pikachuxxxx))
+ * See "LICENSE.txt" for license information.
+ */
+
+#include "r8_halfspace.h"
+#include "r8_texture.h"
+#include "r8_pixel.h"
+#include "r8_external_math.h"
+#include "r8_thread.h"
+
+#if defined(R8_AVX2)
+#   include <immintrin.h>
+#elif defined(R8_SSE2)
+#   include <emmintrin.h>
+#endif
+
+
+// --- internals --- //
+
+#define _BLOCK_SIZE         R8_HALFSPACE_BLOCK_SIZE
+#define _BLOCK_MASK         ((1 << _BLOCK_SIZE) - 1)
+
+#define _SUBPIXEL_ONE       (1 << R8_SUBPIXEL_BITS)
+#define _SUBPIXEL_HALF      (_SUBPIXEL_ONE >> 1)
+
+// Largest magnitude the 32-bit edge functions may reach
+#define _MAX_EDGE_VALUE     2147483647.0
+
+//! Screen space plane equation of an interpolant (at pixel centers, relative to the triangle base pixel): value = c + dx*x + dy*y
+typedef struct R8HalfSpacePlane
+{
+    R8interp c;
+    R8interp dx;
+    R8interp dy;
+}
+R8HalfSpacePlane;
+
+//! Triangle setup for the half-space rasterizer.
+typedef struct R8HalfSpaceTriangle
+{
+    R8int               edges[4];                   // Edge functions (including fill rule bias) at the block grid origin. 4th entry is always 0.
+    R8int               stepX[3];                   // Edge function increments for one pixel in X direction.
+    R8int               stepY[3];                   // Edge function increments for one pixel in Y direction.
+    R8int               minCorner[4];               // Offsets from a block origin to its block corner with the smallest edge function values.
+    R8int               maxCorner[4];               // Offsets from a block origin to its block corner with the largest edge function values.
+    R8int               rowSteps[3][_BLOCK_SIZE];   // Edge function increments for each pixel inside a block row.
+    R8int               baseX;                      // Pixel the interpolant planes are relative to, so they stay accurate in single precision.
+    R8int               baseY;
+    R8HalfSpacePlane    z;
+    R8HalfSpacePlane    u;
+    R8HalfSpacePlane    v;
+}
+R8HalfSpaceTriangle;
+
+static void _setup_plane(
+    R8HalfSpacePlane* plane, R8interp a0, R8interp a1, R8interp a2,
+    R8interp x0, R8interp y0, R8interp x1, R8interp y1, R8interp x2, R8interp y2, R8interp area)
+{
+    plane->dx = ((a1 - a0)*(y2 - y0) - (a2 - a0)*(y1 - y0)) / area;
+    plane->dy = ((a2 - a0)*(x1 - x0) - (a1 - a0)*(x2 - x0)) / area;
+    plane->c  = a0 - plane->dx*(x0 - R8_FLOAT(0.5)) - plane->dy*(y0 - R8_FLOAT(0.5));
+}
+
+// Returns R8_FALSE if the triangle has no area.
+static R8boolean _setup_triangle(
+    R8HalfSpaceTriangle* tri, const R8RasterVertex* a, const R8RasterVertex* b, const R8RasterVertex* c, R8int originX, R8int originY)
+{
+    // Make triangle counter-clockwise, so that all edge functions are positive inside the triangle
+    R8double area = (R8double)(b->subX - a->subX)*(c->subY - a->subY) - (R8double)(b->subY - a->subY)*(c->subX - a->subX);
+
+    if (area == 0.0)
+        return R8_FALSE;
+
+    if (area < 0.0)
+    {
+        R8_SWAP(const R8RasterVertex*, b, c);
+        area = -area;
+    }
+
+    // Setup edge functions relative to the center of the origin pixel
+    const R8RasterVertex* verts[3] = { a, b, c };
+
+    const R8int sampleX = originX * _SUBPIXEL_ONE + _SUBPIXEL_HALF;
+    const R8int sampleY = originY * _SUBPIXEL_ONE + _SUBPIXEL_HALF;
+
+    for (R8int i = 0; i < 3; ++i)
+    {
+        const R8RasterVertex* v0 = verts[i];
+        const R8RasterVertex* v1 = verts[(i + 1) % 3];
+
+        R8int dx = v1->subX - v0->subX;
+        R8int dy = v1->subY - v0->subY;
+
+        // Top-left fill rule: pixel centers exactly on an edge only belong to top and left edges
+        R8int bias = ((dy < 0 || (dy == 0 && dx > 0)) ? 0 : -1);
+
+        tri->edges[i] = dx*(sampleY - v0->subY) - dy*(sampleX - v0->subX) + bias;
+        tri->stepX[i] = -dy * _SUBPIXEL_ONE;
+        tri->stepY[i] = dx * _SUBPIXEL_ONE;
+
+        tri->minCorner[i] = R8_MIN(0, tri->stepX[i]*(_BLOCK_SIZE - 1)) + R8_MIN(0, tri->stepY[i]*(_BLOCK_SIZE - 1));
+        tri->maxCorner[i] = R8_MAX(0, tri->stepX[i]*(_BLOCK_SIZE - 1)) + R8_MAX(0, tri->stepY[i]*(_BLOCK_SIZE - 1));
+
+        for (R8int j = 0; j < _BLOCK_SIZE; ++j)
+            tri->rowSteps[i][j] = tri->stepX[i]*j;
+    }
+
+    tri->edges[3]       = 0;
+    tri->minCorner[3]   = 0;
+    tri->maxCorner[3]   = 0;
+
+    // Setup interpolant planes relative to the pixel of the first vertex (independent of the tile which is rasterized)
+    tri->baseX = a->subX >> R8_SUBPIXEL_BITS;
+    tri->baseY = a->subY >> R8_SUBPIXEL_BITS;
+
+    const R8int baseSubX = tri->baseX * _SUBPIXEL_ONE;
+    const R8int baseSubY = tri->baseY * _SUBPIXEL_ONE;
+
+    const R8interp x0 = (R8interp)(a->subX - baseSubX) / _SUBPIXEL_ONE, y0 = (R8interp)(a->subY - baseSubY) / _SUBPIXEL_ONE;
+    const R8interp x1 = (R8interp)(b->subX - baseSubX) / _SUBPIXEL_ONE, y1 = (R8interp)(b->subY - baseSubY) / _SUBPIXEL_ONE;
+    const R8interp x2 = (R8interp)(c->subX - baseSubX) / _SUBPIXEL_ONE, y2 = (R8interp)(c->subY - baseSubY) / _SUBPIXEL_ONE;
+    const R8interp planeArea = (R8interp)(area / (_SUBPIXEL_ONE * _SUBPIXEL_ONE));
+
+    _setup_plane(&(tri->z), a->z, b->z, c->z, x0, y0, x1, y1, x2, y2, planeArea);
+    _setup_plane(&(tri->u), a->u, b->u, c->u, x0, y0, x1, y1, x2, y2, planeArea);
+    _setup_plane(&(tri->v), a->v, b->v, c->v, x0, y0, x1, y1, x2, y2, planeArea);
+
+    return R8_TRUE;
+}
+
+// Classifies a block: returns -1 if it's entirely outside, 1 if it's entirely inside, and 0 if it's partially covered.
+R8_INLINE R8int _classify_block(const R8HalfSpaceTriangle* tri, const R8int* edges)
+{
+    #if defined(R8_SSE2)
+
+    __m128i e = _mm_loadu_si128((const __m128i*)edges);
+
+    if (_mm_movemask_ps(_mm_castsi128_ps(_mm_add_epi32(e, _mm_loadu_si128((const __m128i*)tri->maxCorner)))) != 0)
+        return -1;
+    if (_mm_movemask_ps(_mm_castsi128_ps(_mm_add_epi32(e, _mm_loadu_si128((const __m128i*)tri->minCorner)))) == 0)
+        return 1;
+
+    #else
+
+    R8int inside = 1;
+
+    for (R8int i = 0; i < 3; ++i)
+    {
+        if (edges[i] + tri->maxCorner[i] < 0)
+            return -1;
+        if (edges[i] + tri->minCorner[i] < 0)
+            inside = 0;
+    }
+
+    if (inside)
+        return 1;
+
+    #endif
+
+    return 0;
+}
+
+// Returns the coverage bit mask of a block row, whose edge functions at the first pixel are 'edges'.
+R8_INLINE R8uint _block_row_mask(const R8HalfSpaceTriangle* tri, const R8int* edges)
+{
+    #if defined(R8_AVX2)
+
+    __m256i e0 = _mm256_add_epi32(_mm256_set1_epi32(edges[0]), _mm256_loadu_si256((const __m256i*)tri->rowSteps[0]));
+    __m256i e1 = _mm256_add_epi32(_mm256_set1_epi32(edges[1]), _mm256_loadu_si256((const __m256i*)tri->rowSteps[1]));
+    __m256i e2 = _mm256_add_epi32(_mm256_set1_epi32(edges[2]), _mm256_loadu_si256((const __m256i*)tri->rowSteps[2]));
+
+    // Pixel is inside if the sign bits of all edge functions are clear
+    __m256i outside = _mm256_or_si256(_mm256_or_si256(e0, e1), e2);
+
+    return (~(R8uint)_mm256_movemask_ps(_mm256_castsi256_ps(outside))) & _BLOCK_MASK;
+
+    #elif defined(R8_SSE2)
+
+    __m128i e0 = _mm_add_epi32(_mm_set1_epi32(edges[0]), _mm_loadu_si128((const __m128i*)tri->rowSteps[0]));
+    __m128i e1 = _mm_add_epi32(_mm_set1_epi32(edges[1]), _mm_loadu_si128((const __m128i*)tri->rowSteps[1]));
+    __m128i e2 = _mm_add_epi32(_mm_set1_epi32(edges[2]), _mm_loadu_si128((const __m128i*)tri->rowSteps[2]));
+
+    // Pixel is inside if the sign bits of all edge functions are clear
+    __m128i outside = _mm_or_si128(_mm_or_si128(e0, e1), e2);
+
+    return (~(R8uint)_mm_movemask_ps(_mm_castsi128_ps(outside))) & _BLOCK_MASK;
+
+    #else
+
+    R8uint mask = 0;
+
+    for (R8int j = 0; j < _BLOCK_SIZE; ++j)
+    {
+        if ((edges[0] + tri->rowSteps[0][j]) >= 0 &&
+            (edges[1] + tri->rowSteps[1][j]) >= 0 &&
+            (edges[2] + tri->rowSteps[2][j]) >= 0)
+        {
+            mask |= (1u << j);
+        }
+    }
+
+    return mask;
+
+    #endif
+}
+
+// Makes the depth test for the specified pixel and samples the texture
+R8_INLINE void _shade_pixel(
+    R8FrameBuffer* frameBuffer, R8int pixel, const R8RasterPolygon* polygon, const R8HalfSpaceTriangle* tri, R8HiZTile* tile, R8int x, R8int y)
+{
+    x -= tri->baseX;
+    y -= tri->baseY;
+
+    R8interp z = tri->z.c + tri->z.dx*x + tri->z.dy*y;
+
+    // Make depth test
+    R8DepthBuffer depth = r8_framebuffer_frame_depth(frameBuffer, r8_pixel_write_depth(z));
+    R8DepthBuffer oldDepth = r8_framebuffer_read_depth(frameBuffer, pixel);
+
+    if (depth > oldDepth)
+    {
+        if (tile != NULL)
+            r8_framebuffer_hiz_write(tile, oldDepth);
+
+        r8_framebuffer_write_depth(frameBuffer, pixel, depth);
+
+        if (polygon->texels == NULL)
+        {
+            R8_FRAMEBUFFER_COLOR(frameBuffer, pixel) = polygon->colorIndex;
+            return;
+        }
+
+        R8interp u = tri->u.c + tri->u.dx*x + tri->u.dy*y;
+        R8interp v = tri->v.c + tri->v.dx*x + tri->v.dy*y;
+
+        #ifdef R8_PERSPECTIVE_CORRECTED
+        // Compute perspective corrected texture coordinates
+        z = R8_FLOAT(1.0) / z;
+        u *= z;
+        v *= z;
+        #endif
+
+        // Sample texture (with bit masks for power-of-two textures)
+        if (polygon->mipPow2)
+        {
+            R8_FRAMEBUFFER_COLOR(frameBuffer, pixel) = r8_texture_sample_nearest_pow2(
+                polygon->texels, polygon->mipWidthShift, (R8uint)polygon->mipWidth - 1, (R8uint)polygon->mipHeight - 1,
+                r8_texture_fixed_coord(u, polygon->mipWidth), r8_texture_fixed_coord(v, polygon->mipHeight)
+            );
+        }
+        else
+            R8_FRAMEBUFFER_COLOR(frameBuffer, pixel) = r8_texture_sample_nearest_from_mipmap(polygon->texels, polygon->mipWidth, polygon->mipHeight, (R8float)u, (R8float)v);
+    }
+}
+
+R8_INLINE R8int _bit_count(R8uint mask)
+{
+    R8int n = 0;
+    for (; mask != 0; mask &= mask - 1)
+        ++n;
+    return n;
+}
+
+// Returns R8_TRUE if the nearest depth of the triangle inside the specified block is behind the farthest pixel of its Hi-Z tile.
+R8_INLINE R8boolean _is_block_occluded(R8FrameBuffer* frameBuffer, const R8HalfSpaceTriangle* tri, R8int x0, R8int y0, R8int x1, R8int y1)
+{
+    // Depth is linear in screen space, so its maximum is at one of the block corners
+    const R8interp lx0 = (R8interp)(x0 - tri->baseX), ly0 = (R8interp)(y0 - tri->baseY);
+    const R8interp lx1 = (R8interp)(x1 - tri->baseX), ly1 = (R8interp)(y1 - tri->baseY);
+
+    R8interp zMax = R8_MAX(
+        R8_MAX(tri->z.c + tri->z.dx*lx0 + tri->z.dy*ly0, tri->z.c + tri->z.dx*lx1 + tri->z.dy*ly0),
+        R8_MAX(tri->z.c + tri->z.dx*lx0 + tri->z.dy*ly1, tri->z.c + tri->z.dx*lx1 + tri->z.dy*ly1)
+    );
+
+    // Corners outside the triangle may exceed the depth range
+    if (zMax >= R8_FLOAT(1.0))
+        return R8_FALSE;
+
+    return r8_framebuffer_hiz_occluded(frameBuffer, x0, y0, r8_framebuffer_frame_depth(frameBuffer, r8_pixel_write_depth(zMax)));
+}
+
+static void _rasterize_triangle(
+    R8FrameBuffer* frameBuffer, const R8RasterPolygon* polygon,
+    const R8RasterVertex* a, const R8RasterVertex* b, const R8RasterVertex* c, const R8Rect* rect)
+{
+    // Get bounding box (in pixels) clamped to the rectangle
+    R8int minX = R8_MIN(a->subX, R8_MIN(b->subX, c->subX)) >> R8_SUBPIXEL_BITS;
+    R8int minY = R8_MIN(a->subY, R8_MIN(b->subY, c->subY)) >> R8_SUBPIXEL_BITS;
+    R8int maxX = R8_MAX(a->subX, R8_MAX(b->subX, c->subX)) >> R8_SUBPIXEL_BITS;
+    R8int maxY = R8_MAX(a->subY, R8_MAX(b->subY, c->subY)) >> R8_SUBPIXEL_BITS;
+
+    minX = R8_MAX(minX, rect->left);
+    minY = R8_MAX(minY, rect->top);
+    maxX = R8_MIN(maxX, rect->right);
+    maxY = R8_MIN(maxY, rect->bottom);
+
+    if (minX > maxX || minY > maxY)
+        return;
+
+    // Align blocks to a global grid, so all tiles are rasterized the same way
+    const R8int originX = minX & ~(_BLOCK_SIZE - 1);
+    const R8int originY = minY & ~(_BLOCK_SIZE - 1);
+
+    R8HalfSpaceTriangle tri;
+    if (_setup_triangle(&tri, a, b, c, originX, originY) == R8_FALSE)
+        return;
+
+    R8int rejectedSpans = 0, rejectedPixels = 0;
+
+    R8int blockRow[4], block[4], row[3];
+    R8int bx, by, x, y, i;
+
+    for (i = 0; i < 4; ++i)
+        blockRow[i] = tri.edges[i];
+
+    for (by = originY; by <= maxY; by += _BLOCK_SIZE)
+    {
+        for (i = 0; i < 4; ++i)
+            block[i] = blockRow[i];
+
+        const R8int y0 = R8_MAX(by, minY);
+        const R8int y1 = R8_MIN(by + _BLOCK_SIZE - 1, maxY);
+
+        for (bx = originX; bx <= maxX; bx += _BLOCK_SIZE)
+        {
+            const R8int classification = _classify_block(&tri, block);
+
+            if (classification >= 0)
+            {
+                const R8int x0 = R8_MAX(bx, minX);
+                const R8int x1 = R8_MIN(bx + _BLOCK_SIZE - 1, maxX);
+
+                // Test block against the Hi-Z tile it lies in (blocks never cross Hi-Z tiles)
+                R8HiZTile* tile = NULL;
+                R8boolean occluded = R8_FALSE;
+
+                if (polygon->hierarchicalZ)
+                {
+                    if (_is_block_occluded(frameBuffer, &tri, x0, y0, x1, y1))
+                        occluded = R8_TRUE;
+                    else
+                        tile = r8_framebuffer_hiz_tile(frameBuffer, bx, by);
+                }
+
+                if (classification > 0)
+                {
+                    // Block is entirely inside the triangle
+                    if (occluded)
+                    {
+                        rejectedSpans += y1 - y0 + 1;
+                        rejectedPixels += (x1 - x0 + 1)*(y1 - y0 + 1);
+                    }
+                    else
+                    {
+                        for (y = y0; y <= y1; ++y)
+                        {
+                            for (x = x0; x <= x1; ++x)
+                                _shade_pixel(frameBuffer, r8_framebuffer_index(frameBuffer, x, y), polygon, &tri, tile, x, y);
+                        }
+                    }
+                }
+                else
+                {
+                    // Block is partially covered, so test each row
+                    const R8uint rangeMask = (_BLOCK_MASK >> (_BLOCK_SIZE - 1 - (x1 - bx))) & ~((1u << (x0 - bx)) - 1);
+
+                    for (i = 0; i < 3; ++i)
+                        row[i] = block[i] + tri.stepY[i]*(y0 - by);
+
+                    for (y = y0; y <= y1; ++y)
+                    {
+                        R8uint mask = _block_row_mask(&tri, row) & rangeMask;
+
+                        if (mask != 0 && occluded)
+                        {
+                            ++rejectedSpans;
+                            rejectedPixels += _bit_count(mask);
+                        }
+                        else if (mask != 0)
+                        {
+                            for (x = x0; x <= x1; ++x)
+                            {
+                                if ((mask & (1u << (x - bx))) != 0)
+                                    _shade_pixel(frameBuffer, r8_framebuffer_index(frameBuffer, x, y), polygon, &tri, tile, x, y);
+                            }
+                        }
+
+                        for (i = 0; i < 3; ++i)
+                            row[i] += tri.stepY[i];
+                    }
+                }
+            }
+
+            // Next block in X direction
+            for (i = 0; i < 3; ++i)
+                block[i] += tri.stepX[i]*_BLOCK_SIZE;
+        }
+
+        // Next block row
+        for (i = 0; i < 3; ++i)
+            blockRow[i] += tri.stepY[i]*_BLOCK_SIZE;
+    }
+
+    if (rejectedSpans > 0)
+    {
+        r8_atomic_add(&(frameBuffer->hizRejectedSpans), rejectedSpans);
+        r8_atomic_add(&(frameBuffer->hizRejectedPixels), rejectedPixels);
+    }
+}
+
+
+// --- interface --- //
+
+R8boolean r8_halfspace_rasterize_polygon(R8FrameBuffer* frameBuffer, const R8RasterPolygon* polygon, const R8Rect* rect)
+{
+    const R8RasterVertex* vertices = polygon->vertices;
+
+    // Edge functions must not exceed 32 bits anywhere inside the (block aligned) bounding box
+    R8int minX = vertices[0].subX, maxX = minX;
+    R8int minY = vertices[0].subY, maxY = minY;
+
+    for (R8int i = 1; i < polygon->numVertices; ++i)
+    {
+        minX = R8_MIN(minX, vertices[i].subX);
+        maxX = R8_MAX(maxX, vertices[i].subX);
+        minY = R8_MIN(minY, vertices[i].subY);
+        maxY = R8_MAX(maxY, vertices[i].subY);
+    }
+
+    R8double extentX = (R8double)(maxX - minX) + 2*_BLOCK_SIZE*_SUBPIXEL_ONE;
+    R8double extentY = (R8double)(maxY - minY) + 2*_BLOCK_SIZE*_SUBPIXEL_ONE;
+
+    if (2.0 * extentX * extentY >= _MAX_EDGE_VALUE)
+        return R8_FALSE;
+
+    // Rasterize polygon as triangle fan
+    for (R8int i = 1; i + 1 < polygon->numVertices; ++i)
+        _rasterize_triangle(frameBuffer, polygon, &(vertices[0]), &(vertices[i]), &(vertices[i + 1]), rect);
+
+    return R8_TRUE;
+}
+
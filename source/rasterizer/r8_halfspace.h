@@ -0,0 +1,35 @@
+/*
+ * r8_halfspace.h
+ *
+ * This file is part of the "R8" (Copyright(c) 2021 by Phani Srikar (Pikachuxxxx))
+ * See "LICENSE.txt" for license information.
+ */
+
+#ifndef R8_HALFSPACE_H
+#define R8_HALFSPACE_H
+
+
+#include "r8_types.h"
+#include "r8_config.h"
+#include "r8_framebuffer.h"
+#include "r8_raster_polygon.h"
+#include "r8_rect.h"
+
+
+// Width and height (in pixels) of the blocks which are tested against the edge functions at once
+#if defined(R8_AVX2)
+#   define R8_HALFSPACE_BLOCK_SIZE  8
+#else
+#   define R8_HALFSPACE_BLOCK_SIZE  4
+#endif
+
+
+/**
+Rasterizes the specified filled polygon with integer edge functions (using the top-left fill rule).
+Only the pixels inside 'rect' are written. This function is thread safe as long as the rectangles don't overlap.
+\return R8_FALSE if the polygon is too large for the 32-bit edge functions. In this case nothing has been rasterized.
+*/
+R8boolean r8_halfspace_rasterize_polygon(R8FrameBuffer* frameBuffer, const R8RasterPolygon* polygon, const R8Rect* rect);
+
+
+#endif
@@ -11,14 +11,52 @@
 #include "r8_state_machine.h"
 
 #include <stdlib.h>
+#include <string.h>
 
 
+static R8sizei _index_size(R8enum indexType)
+{
+    return (indexType == R8_UNSIGNED_INT ? sizeof(R8uint) : sizeof(R8ushort));
+}
+
+static void _indexbuffer_free(R8IndexBuffer* indexBuffer)
+{
+    if (!indexBuffer->external)
+        R8_FREE(indexBuffer->indices);
+
+    indexBuffer->indices    = NULL;
+    indexBuffer->external   = R8_FALSE;
+
+    r8_indexbuffer_free_meshlets(indexBuffer);
+}
+
+static void _indexbuffer_resize(R8IndexBuffer* indexBuffer, R8enum indexType, R8sizei numIndices)
+{
+    // Check if index buffer must be reallocated (external indices are never written)
+    if (indexBuffer->indices == NULL || indexBuffer->numIndices != numIndices || indexBuffer->indexType != indexType || indexBuffer->external)
+    {
+        // Create new index buffer data
+        _indexbuffer_free(indexBuffer);
+
+        indexBuffer->numIndices = numIndices;
+        indexBuffer->indexType  = indexType;
+        indexBuffer->indices    = calloc(numIndices, _index_size(indexType));
+    }
+}
+
 R8IndexBuffer* r8_indexbuffer_create()
 {
     R8IndexBuffer* indexBuffer = R8_MALLOC(R8IndexBuffer);
 
     indexBuffer->numIndices = 0;
+    indexBuffer->indexType  = R8_UNSIGNED_SHORT;
     indexBuffer->indices    = NULL;
+    indexBuffer->external   = R8_FALSE;
+
+    indexBuffer->meshlets               = NULL;
+    indexBuffer->numMeshlets            = 0;
+    indexBuffer->meshletVertexBuffer    = NULL;
+    indexBuffer->meshletGeneration      = 0;
 
     r8_ref_add(indexBuffer);
 
@@ -31,37 +69,72 @@ void r8_indexbuffer_delete(R8IndexBuffer* indexBuffer)
     {
         r8_ref_release(indexBuffer);
 
-        R8_FREE(indexBuffer->indices);
+        _indexbuffer_free(indexBuffer);
         R8_FREE(indexBuffer);
     }
 }
 
-static void _indexbuffer_resize(R8IndexBuffer* indexBuffer, R8ushort numIndices)
+void r8_indexbuffer_data(R8IndexBuffer* indexBuffer, const R8void* indices, R8enum indexType, R8sizei numIndices)
 {
-    // Check if index buffer must be reallocated
-    if (indexBuffer->indices == NULL || indexBuffer->numIndices != numIndices)
+    if (indexBuffer == NULL || indices == NULL)
     {
-        // Create new index buffer data
-        R8_FREE(indexBuffer->indices);
-
-        indexBuffer->numIndices = numIndices;
-        indexBuffer->indices    = R8_CALLOC(R8ushort, numIndices);
+        R8_ERROR(R8_ERROR_NULL_POINTER);
+        return;
+    }
+    if ((indexType != R8_UNSIGNED_SHORT && indexType != R8_UNSIGNED_INT) || numIndices < 0)
+    {
+        R8_ERROR(R8_ERROR_INVALID_ARGUMENT);
+        return;
     }
+
+    _indexbuffer_resize(indexBuffer, indexType, numIndices);
+
+    // Fill index buffer (the meshlets don't match the new indices anymore)
+    memcpy(indexBuffer->indices, indices, numIndices * _index_size(indexType));
+
+    r8_indexbuffer_free_meshlets(indexBuffer);
 }
 
-void r8_indexbuffer_data(R8IndexBuffer* indexBuffer, const R8ushort* indices, R8ushort numIndices)
+void r8_indexbuffer_free_meshlets(R8IndexBuffer* indexBuffer)
 {
-    if (indexBuffer == NULL || indices == NULL)
+    R8_FREE(indexBuffer->meshlets);
+
+    indexBuffer->numMeshlets            = 0;
+    indexBuffer->meshletVertexBuffer    = NULL;
+    indexBuffer->meshletGeneration      = 0;
+}
+
+void r8_indexbuffer_reference(R8IndexBuffer* indexBuffer, const R8void* indices, R8enum indexType, R8sizei numIndices)
+{
+    _indexbuffer_free(indexBuffer);
+
+    // The indices are only read while drawing, so they can be mapped read-only
+    indexBuffer->numIndices = numIndices;
+    indexBuffer->indexType  = indexType;
+    indexBuffer->indices    = (R8void*)indices;
+    indexBuffer->external   = R8_TRUE;
+}
+
+R8sizei r8_file_read_count(FILE* file, R8boolean* is32Bit)
+{
+    R8ushort count16 = 0;
+    fread(&count16, sizeof(R8ushort), 1, file);
+
+    if (count16 == R8_FILE_COUNT_32BIT)
     {
-        R8_ERROR(R8_ERROR_NULL_POINTER);
-        return;
+        R8uint count32 = 0;
+        fread(&count32, sizeof(R8uint), 1, file);
+
+        if (is32Bit != NULL)
+            *is32Bit = R8_TRUE;
+
+        return (R8sizei)count32;
     }
 
-    _indexbuffer_resize(indexBuffer, numIndices);
+    if (is32Bit != NULL)
+        *is32Bit = R8_FALSE;
 
-    // Fill index buffer
-    while (numIndices-- > 0)
-        indexBuffer->indices[numIndices] = indices[numIndices];
+    return (R8sizei)count16;
 }
 
 void r8_indexbuffer_data_from_file(R8IndexBuffer* indexBuffer, R8sizei* numIndices, FILE* file)
@@ -72,14 +145,16 @@ void r8_indexbuffer_data_from_file(R8IndexBuffer* indexBuffer, R8sizei* numIndic
         return;
     }
 
-    // Read number of indices
-    R8ushort numInd = 0;
-    fread(&numInd, sizeof(R8ushort), 1, file);
-    *numIndices = (R8sizei)numInd;
+    // Read number of indices (a 32-bit count also selects 32-bit indices)
+    R8boolean is32Bit = R8_FALSE;
+    *numIndices = r8_file_read_count(file, &is32Bit);
 
-    _indexbuffer_resize(indexBuffer, *numIndices);
+    const R8enum indexType = (is32Bit ? R8_UNSIGNED_INT : R8_UNSIGNED_SHORT);
+    _indexbuffer_resize(indexBuffer, indexType, *numIndices);
 
     // Read all indices
-    fread(indexBuffer->indices, sizeof(R8ushort), *numIndices, file);
-}
+    if (fread(indexBuffer->indices, _index_size(indexType), *numIndices, file) != (size_t)*numIndices)
+        R8_ERROR(R8_ERROR_UNEXPECTED_EOF);
 
+    r8_indexbuffer_free_meshlets(indexBuffer);
+}
@@ -10,14 +10,26 @@
 
 
 #include "r8_types.h"
+#include "r8_macros.h"
 
 #include <stdio.h>
 
 
+// Escape value of the 16-bit count in the file formats, which is followed by a 32-bit count.
+#define R8_FILE_COUNT_32BIT 0xFFFF
+
+
 typedef struct R8IndexBuffer
 {
-    R8ushort    numIndices;
-    R8ushort*   indices;
+    R8sizei     numIndices;
+    R8enum      indexType;  // Either R8_UNSIGNED_SHORT or R8_UNSIGNED_INT.
+    R8void*     indices;
+    R8boolean   external;   // Indices reference external memory (e.g. a mapped mesh file), which is not owned by the buffer.
+
+    struct R8Meshlet*               meshlets;               // Optional triangle clusters (see 'r8_meshlet_build'), or null.
+    R8sizei                         numMeshlets;
+    const struct R8VertexBuffer*    meshletVertexBuffer;    // Vertex buffer the meshlets have been built for.
+    R8uint                          meshletGeneration;      // Generation of that buffer's vertex data when the meshlets have been built.
 }
 R8IndexBuffer;
 
@@ -25,8 +37,26 @@ R8IndexBuffer;
 R8IndexBuffer* r8_indexbuffer_create();
 void r8_indexbuffer_delete(R8IndexBuffer* indexBuffer);
 
-void r8_indexbuffer_data(R8IndexBuffer* indexBuffer, const R8ushort* indices, R8ushort numIndices);
+void r8_indexbuffer_data(R8IndexBuffer* indexBuffer, const R8void* indices, R8enum indexType, R8sizei numIndices);
 void r8_indexbuffer_data_from_file(R8IndexBuffer* indexBuffer, R8sizei* numIndices, FILE* file);
 
+// Uses the specified indices in place (zero-copy). They must stay valid until the buffer is deleted or its data is replaced.
+void r8_indexbuffer_reference(R8IndexBuffer* indexBuffer, const R8void* indices, R8enum indexType, R8sizei numIndices);
+
+// Releases the meshlets of the index buffer (they are also released when the index data is replaced).
+void r8_indexbuffer_free_meshlets(R8IndexBuffer* indexBuffer);
+
+// Reads a 16-bit count from the file, or the following 32-bit count if the 16-bit count is R8_FILE_COUNT_32BIT.
+R8sizei r8_file_read_count(FILE* file, R8boolean* is32Bit);
+
+// Returns the index at the specified position of the index buffer.
+R8_INLINE R8uint r8_indexbuffer_get(const R8IndexBuffer* indexBuffer, R8sizei i)
+{
+    if (indexBuffer->indexType == R8_UNSIGNED_INT)
+        return ((const R8uint*)indexBuffer->indices)[i];
+    else
+        return ((const R8ushort*)indexBuffer->indices)[i];
+}
+
 
 #endif
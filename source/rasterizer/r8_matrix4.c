@@ -7,11 +7,57 @@
 
 #include "r8_matrix4.h"
 #include "r8_error.h"
+#include "r8_config.h"
 #include "r8_external_math.h"
 
 #include <string.h>
 #include <math.h>
 
+#if defined(R8_AVX2)
+#   include <immintrin.h>
+#elif defined(R8_SSE2)
+#   include <emmintrin.h>
+#endif
+
+
+/*
+All kernels sum up each output component in the same order (column 0 to 3), so the SIMD and scalar paths are bit identical.
+Matrices are loaded unaligned, because the public interface accepts any float arrays as matrices.
+*/
+
+// --- internals --- //
+
+#if defined(R8_SSE2)
+
+R8_INLINE void _load_columns(__m128* columns, const R8Matrix4* matrix)
+{
+    columns[0] = _mm_loadu_ps(matrix->m[0]);
+    columns[1] = _mm_loadu_ps(matrix->m[1]);
+    columns[2] = _mm_loadu_ps(matrix->m[2]);
+    columns[3] = _mm_loadu_ps(matrix->m[3]);
+}
+
+// Returns the linear combination of the four columns with the components of 'v'.
+R8_INLINE __m128 _mul_columns(const __m128* columns, const R8float* v)
+{
+    __m128 r = _mm_mul_ps(columns[0], _mm_set1_ps(v[0]));
+    r = _mm_add_ps(r, _mm_mul_ps(columns[1], _mm_set1_ps(v[1])));
+    r = _mm_add_ps(r, _mm_mul_ps(columns[2], _mm_set1_ps(v[2])));
+    r = _mm_add_ps(r, _mm_mul_ps(columns[3], _mm_set1_ps(v[3])));
+    return r;
+}
+
+#else
+
+R8_INLINE void _mul_columns(R8float* result, const R8Matrix4* lhs, const R8float* v)
+{
+    for (R8int r = 0; r < 4; ++r)
+        result[r] = (lhs->m[0][r] * v[0]) + (lhs->m[1][r] * v[1]) + (lhs->m[2][r] * v[2]) + (lhs->m[3][r] * v[3]);
+}
+
+#endif
+
+// --- interface --- //
 
 void r8_matrix_load_identity(R8Matrix4* matrix)
 {
@@ -35,10 +81,76 @@ void r8_matrix_mul_float3(R8float* result, const R8Matrix4* lhs, const R8float*
 
 void r8_matrix_mul_float4(R8float* result, const R8Matrix4* lhs, const R8float* rhs)
 {
-    result[0] = (lhs->m[0][0] * rhs[0]) + (lhs->m[1][0] * rhs[1]) + (lhs->m[2][0] * rhs[2]) + (lhs->m[3][0] * rhs[3]);
-    result[1] = (lhs->m[0][1] * rhs[0]) + (lhs->m[1][1] * rhs[1]) + (lhs->m[2][1] * rhs[2]) + (lhs->m[3][1] * rhs[3]);
-    result[2] = (lhs->m[0][2] * rhs[0]) + (lhs->m[1][2] * rhs[1]) + (lhs->m[2][2] * rhs[2]) + (lhs->m[3][2] * rhs[3]);
-    result[3] = (lhs->m[0][3] * rhs[0]) + (lhs->m[1][3] * rhs[1]) + (lhs->m[2][3] * rhs[2]) + (lhs->m[3][3] * rhs[3]);
+    #if defined(R8_SSE2)
+
+    __m128 columns[4];
+    _load_columns(columns, lhs);
+    _mm_storeu_ps(result, _mul_columns(columns, rhs));
+
+    #else
+
+    R8float v[4];
+    _mul_columns(v, lhs, rhs);
+    memcpy(result, v, sizeof(v));
+
+    #endif
+}
+
+void r8_matrix_mul_float4_streams(R8float* const* results, const R8Matrix4* lhs, const R8float* const* rhs, R8sizei count)
+{
+    const R8Matrix4* m = lhs;
+    R8sizei i = 0;
+
+    #if defined(R8_AVX2)
+
+    for (; i + 8 <= count; i += 8)
+    {
+        __m256 x = _mm256_loadu_ps(rhs[0] + i);
+        __m256 y = _mm256_loadu_ps(rhs[1] + i);
+        __m256 z = _mm256_loadu_ps(rhs[2] + i);
+        __m256 w = _mm256_loadu_ps(rhs[3] + i);
+
+        for (R8int r = 0; r < 4; ++r)
+        {
+            __m256 v = _mm256_mul_ps(_mm256_set1_ps(m->m[0][r]), x);
+            v = _mm256_add_ps(v, _mm256_mul_ps(_mm256_set1_ps(m->m[1][r]), y));
+            v = _mm256_add_ps(v, _mm256_mul_ps(_mm256_set1_ps(m->m[2][r]), z));
+            v = _mm256_add_ps(v, _mm256_mul_ps(_mm256_set1_ps(m->m[3][r]), w));
+            _mm256_storeu_ps(results[r] + i, v);
+        }
+    }
+
+    #elif defined(R8_SSE2)
+
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 x = _mm_loadu_ps(rhs[0] + i);
+        __m128 y = _mm_loadu_ps(rhs[1] + i);
+        __m128 z = _mm_loadu_ps(rhs[2] + i);
+        __m128 w = _mm_loadu_ps(rhs[3] + i);
+
+        for (R8int r = 0; r < 4; ++r)
+        {
+            __m128 v = _mm_mul_ps(_mm_set1_ps(m->m[0][r]), x);
+            v = _mm_add_ps(v, _mm_mul_ps(_mm_set1_ps(m->m[1][r]), y));
+            v = _mm_add_ps(v, _mm_mul_ps(_mm_set1_ps(m->m[2][r]), z));
+            v = _mm_add_ps(v, _mm_mul_ps(_mm_set1_ps(m->m[3][r]), w));
+            _mm_storeu_ps(results[r] + i, v);
+        }
+    }
+
+    #endif
+
+    // Transform remaining vectors
+    for (; i < count; ++i)
+    {
+        for (R8int r = 0; r < 4; ++r)
+        {
+            results[r][i] =
+                (m->m[0][r] * rhs[0][i]) + (m->m[1][r] * rhs[1][i]) +
+                (m->m[2][r] * rhs[2][i]) + (m->m[3][r] * rhs[3][i]);
+        }
+    }
 }
 
 void r8_matrix_mul_vector3(R8Vector3* result, const R8Matrix4* lhs, const R8Vector3* rhs)
@@ -53,38 +165,61 @@ void r8_matrix_mul_vector4(R8Vector4* result, const R8Matrix4* lhs, const R8Vect
 
 void r8_matrix_mul_matrix(R8Matrix4* result, const R8Matrix4* lhs, const R8Matrix4* rhs)
 {
-    R8float* m3 = &(result->m[0][0]);
-    const R8float* m1 = &(lhs->m[0][0]);
-    const R8float* m2 = &(rhs->m[0][0]);
+    r8_matrix_mul_matrices(result, lhs, rhs, 1);
+}
 
-    m3[ 0] = m1[0]*m2[ 0] + m1[4]*m2[ 1] + m1[ 8]*m2[ 2] + m1[12]*m2[ 3];
-    m3[ 1] = m1[1]*m2[ 0] + m1[5]*m2[ 1] + m1[ 9]*m2[ 2] + m1[13]*m2[ 3];
-    m3[ 2] = m1[2]*m2[ 0] + m1[6]*m2[ 1] + m1[10]*m2[ 2] + m1[14]*m2[ 3];
-    m3[ 3] = m1[3]*m2[ 0] + m1[7]*m2[ 1] + m1[11]*m2[ 2] + m1[15]*m2[ 3];
+void r8_matrix_mul_matrices(R8Matrix4* results, const R8Matrix4* lhs, const R8Matrix4* rhs, R8sizei count)
+{
+    #if defined(R8_SSE2)
 
-    m3[ 4] = m1[0]*m2[ 4] + m1[4]*m2[ 5] + m1[ 8]*m2[ 6] + m1[12]*m2[ 7];
-    m3[ 5] = m1[1]*m2[ 4] + m1[5]*m2[ 5] + m1[ 9]*m2[ 6] + m1[13]*m2[ 7];
-    m3[ 6] = m1[2]*m2[ 4] + m1[6]*m2[ 5] + m1[10]*m2[ 6] + m1[14]*m2[ 7];
-    m3[ 7] = m1[3]*m2[ 4] + m1[7]*m2[ 5] + m1[11]*m2[ 6] + m1[15]*m2[ 7];
+    // Keep the columns of the shared matrix in registers
+    __m128 columns[4];
+    _load_columns(columns, lhs);
 
-    m3[ 8] = m1[0]*m2[ 8] + m1[4]*m2[ 9] + m1[ 8]*m2[10] + m1[12]*m2[11];
-    m3[ 9] = m1[1]*m2[ 8] + m1[5]*m2[ 9] + m1[ 9]*m2[10] + m1[13]*m2[11];
-    m3[10] = m1[2]*m2[ 8] + m1[6]*m2[ 9] + m1[10]*m2[10] + m1[14]*m2[11];
-    m3[11] = m1[3]*m2[ 8] + m1[7]*m2[ 9] + m1[11]*m2[10] + m1[15]*m2[11];
+    for (R8sizei i = 0; i < count; ++i)
+    {
+        // Each result column only depends on the same column of 'rhs', so the result may alias 'rhs'
+        for (R8int c = 0; c < 4; ++c)
+            _mm_storeu_ps(results[i].m[c], _mul_columns(columns, rhs[i].m[c]));
+    }
+
+    #else
 
-    m3[12] = m1[0]*m2[12] + m1[4]*m2[13] + m1[ 8]*m2[14] + m1[12]*m2[15];
-    m3[13] = m1[1]*m2[12] + m1[5]*m2[13] + m1[ 9]*m2[14] + m1[13]*m2[15];
-    m3[14] = m1[2]*m2[12] + m1[6]*m2[13] + m1[10]*m2[14] + m1[14]*m2[15];
-    m3[15] = m1[3]*m2[12] + m1[7]*m2[13] + m1[11]*m2[14] + m1[15]*m2[15];
+    R8Matrix4 m;
+    r8_matrix_copy(&m, lhs);
+
+    for (R8sizei i = 0; i < count; ++i)
+    {
+        R8float v[4];
+        for (R8int c = 0; c < 4; ++c)
+        {
+            _mul_columns(v, &m, rhs[i].m[c]);
+            memcpy(results[i].m[c], v, sizeof(v));
+        }
+    }
+
+    #endif
 }
 
 void r8_matrix_translate(R8Matrix4* result, R8float x, R8float y, R8float z)
 {
     R8float* m = &(result->m[0][0]);
+
+    #if defined(R8_SSE2)
+
+    __m128 t = _mm_mul_ps(_mm_loadu_ps(m), _mm_set1_ps(x));
+    t = _mm_add_ps(t, _mm_mul_ps(_mm_loadu_ps(m + 4), _mm_set1_ps(y)));
+    t = _mm_add_ps(t, _mm_mul_ps(_mm_loadu_ps(m + 8), _mm_set1_ps(z)));
+    _mm_storeu_ps(m + 12, _mm_add_ps(_mm_loadu_ps(m + 12), t));
+
+    #else
+
     m[12] += ( m[0]*x + m[4]*y + m[ 8]*z );
     m[13] += ( m[1]*x + m[5]*y + m[ 9]*z );
     m[14] += ( m[2]*x + m[6]*y + m[10]*z );
     m[15] += ( m[3]*x + m[7]*y + m[11]*z );
+
+    #endif
 }
 
 void r8_matrix_rotate(R8Matrix4* result, R8float x, R8float y, R8float z, R8float angle)
@@ -105,28 +240,52 @@ void r8_matrix_rotate(R8Matrix4* result, R8float x, R8float y, R8float z, R8floa
     const R8float c = R8_COS(angle);
     const R8float cc = 1.0f - c;
 
-    // Setup rotation matrix
-    R8Matrix4 rhs;
-    R8float* m = &(rhs.m[0][0]);
+    // Setup the upper 3x3 part of the rotation matrix (column-major, the translation column is the identity)
+    const R8float rot[3][4] =
+    {
+        { x*x*cc + c,   y*x*cc + z*s, x*z*cc - y*s, 0.0f },
+        { x*y*cc - z*s, y*y*cc + c,   y*z*cc + x*s, 0.0f },
+        { x*z*cc + y*s, y*z*cc - x*s, z*z*cc + c,   0.0f },
+    };
+
+    // Multiply input matrix (lhs) with rotation matrix (rhs) in place, only the first three columns change
+    #if defined(R8_SSE2)
+
+    __m128 columns[4];
+    _load_columns(columns, result);
+
+    for (R8int i = 0; i < 3; ++i)
+        _mm_storeu_ps(result->m[i], _mul_columns(columns, rot[i]));
 
-    m[0] = x*x*cc + c;   m[4] = x*y*cc - z*s; m[ 8] = x*z*cc + y*s; m[12] = 0.0f;
-    m[1] = y*x*cc + z*s; m[5] = y*y*cc + c;   m[ 9] = y*z*cc - x*s; m[13] = 0.0f;
-    m[2] = x*z*cc - y*s; m[6] = y*z*cc + x*s; m[10] = z*z*cc + c;   m[14] = 0.0f;
-    m[3] = 0.0f;         m[7] = 0.0f;         m[11] = 0.0f;         m[15] = 1.0f;
+    #else
 
-    // Multiply input matrix (lhs) with rotation matrix (rhs)
-    R8Matrix4 lhs;
-    r8_matrix_copy(&lhs, result);
+    R8float v[3][4];
 
-    r8_matrix_mul_matrix(result, &lhs, &rhs);
+    for (R8int i = 0; i < 3; ++i)
+        _mul_columns(v[i], result, rot[i]);
+
+    memcpy(result->m, v, sizeof(v));
+
+    #endif
 }
 
 void r8_matrix_scale(R8Matrix4* result, R8float x, R8float y, R8float z)
 {
     R8float* m = &(result->m[0][0]);
+
+    #if defined(R8_SSE2)
+
+    _mm_storeu_ps(m,     _mm_mul_ps(_mm_loadu_ps(m    ), _mm_set1_ps(x)));
+    _mm_storeu_ps(m + 4, _mm_mul_ps(_mm_loadu_ps(m + 4), _mm_set1_ps(y)));
+    _mm_storeu_ps(m + 8, _mm_mul_ps(_mm_loadu_ps(m + 8), _mm_set1_ps(z)));
+
+    #else
+
     m[0] *= x; m[1] *= x; m[ 2] *= x; m[ 3] *= x;
     m[4] *= y; m[5] *= y; m[ 6] *= y; m[ 7] *= y;
     m[8] *= z; m[9] *= z; m[10] *= z; m[11] *= z;
+
+    #endif
 }
 
 void r8_matrix_build_perspective(R8Matrix4* result, R8float aspectRatio, R8float nearPlane, R8float farPlane, R8float fov)
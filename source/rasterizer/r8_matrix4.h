@@ -30,11 +30,17 @@ void r8_matrix_copy(R8Matrix4* dst, const R8Matrix4* src);
 void r8_matrix_mul_float3(R8float* result, const R8Matrix4* lhs, const R8float* rhs);
 void r8_matrix_mul_float4(R8float* result, const R8Matrix4* lhs, const R8float* rhs);
 
+// Multiplies the matrix 'lhs' with 'count' vectors, which are stored in four streams (X, Y, Z, W), and stores the products in the four 'results' streams.
+void r8_matrix_mul_float4_streams(R8float* const* results, const R8Matrix4* lhs, const R8float* const* rhs, R8sizei count);
+
 void r8_matrix_mul_vector3(R8Vector3* result, const R8Matrix4* lhs, const R8Vector3* rhs);
 void r8_matrix_mul_vector4(R8Vector4* result, const R8Matrix4* lhs, const R8Vector4* rhs);
 
 void r8_matrix_mul_matrix(R8Matrix4* result, const R8Matrix4* lhs, const R8Matrix4* rhs);
 
+// Multiplies the matrix 'lhs' with each of the 'count' matrices in 'rhs' and stores the products in 'results'.
+void r8_matrix_mul_matrices(R8Matrix4* results, const R8Matrix4* lhs, const R8Matrix4* rhs, R8sizei count);
+
 void r8_matrix_translate(R8Matrix4* result, R8float x, R8float y, R8float z);
 void r8_matrix_rotate(R8Matrix4* result, R8float x, R8float y, R8float z, R8float angle);
 void r8_matrix_scale(R8Matrix4* result, R8float x, R8float y, R8float z);
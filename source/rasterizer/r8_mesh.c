@@ -0,0 +1,317 @@
+/*
+ * r8_mesh.c
+ *
+ * This file is part of the "R8" (Copyright(c) 2021 by Phani Srikar (Pikachuxxxx))
+ * See "LICENSE.txt" for license information.
+ */
+
+#include "r8_mesh.h"
+#include "r8_state_machine.h"
+#include "r8_error.h"
+#include "r8_memory.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <float.h>
+
+#ifndef _WIN32
+#   include <sys/mman.h>
+#   include <sys/stat.h>
+#   include <fcntl.h>
+#   include <unistd.h>
+#endif
+
+
+// --- internals --- //
+
+static R8boolean _file_map(R8FileMapping* fileMapping, const char* filename)
+{
+    memset(fileMapping, 0, sizeof(R8FileMapping));
+
+    #ifdef _WIN32
+
+    fileMapping->file = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (fileMapping->file == INVALID_HANDLE_VALUE)
+        return R8_FALSE;
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(fileMapping->file, &size) || size.QuadPart == 0)
+    {
+        CloseHandle(fileMapping->file);
+        return R8_FALSE;
+    }
+
+    fileMapping->mapping = CreateFileMappingA(fileMapping->file, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (fileMapping->mapping == NULL)
+    {
+        CloseHandle(fileMapping->file);
+        return R8_FALSE;
+    }
+
+    fileMapping->data = MapViewOfFile(fileMapping->mapping, FILE_MAP_READ, 0, 0, 0);
+    fileMapping->size = (size_t)size.QuadPart;
+
+    if (fileMapping->data == NULL)
+    {
+        CloseHandle(fileMapping->mapping);
+        CloseHandle(fileMapping->file);
+        return R8_FALSE;
+    }
+
+    #else
+
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0)
+        return R8_FALSE;
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size == 0)
+    {
+        close(fd);
+        return R8_FALSE;
+    }
+
+    // The mapping stays valid after the file descriptor has been closed
+    void* data = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+
+    if (data == MAP_FAILED)
+        return R8_FALSE;
+
+    fileMapping->data = data;
+    fileMapping->size = (size_t)info.st_size;
+
+    #endif
+
+    return R8_TRUE;
+}
+
+static void _file_unmap(R8FileMapping* fileMapping)
+{
+    if (fileMapping->data == NULL)
+        return;
+
+    #ifdef _WIN32
+    UnmapViewOfFile(fileMapping->data);
+    CloseHandle(fileMapping->mapping);
+    CloseHandle(fileMapping->file);
+    #else
+    munmap((void*)fileMapping->data, fileMapping->size);
+    #endif
+
+    memset(fileMapping, 0, sizeof(R8FileMapping));
+}
+
+static R8uint _index_size(R8uint indexType)
+{
+    return (indexType == R8_UNSIGNED_INT ? sizeof(R8uint) : sizeof(R8ushort));
+}
+
+// Returns R8_TRUE if the range [offset, offset + size) is aligned and lies inside the file.
+static R8boolean _is_range_valid(const R8MeshFileHeader* header, R8uint offset, size_t size)
+{
+    return (offset % R8_MESH_FILE_ALIGNMENT == 0 && offset >= sizeof(R8MeshFileHeader) && (size_t)offset + size <= header->fileSize);
+}
+
+static R8boolean _validate_header(const R8MeshFileHeader* header, size_t fileSize)
+{
+    if (fileSize < sizeof(R8MeshFileHeader))
+        return R8_FALSE;
+    if (header->magic != R8_MESH_FILE_MAGIC || header->version != R8_MESH_FILE_VERSION || header->fileSize != fileSize)
+        return R8_FALSE;
+    if (header->indexType != R8_UNSIGNED_SHORT && header->indexType != R8_UNSIGNED_INT)
+        return R8_FALSE;
+    if (header->numVertices > 0x7FFFFFFF || header->numIndices > 0x7FFFFFFF)
+        return R8_FALSE;
+
+    const size_t streamSize = (size_t)header->numVertices * sizeof(R8float);
+
+    for (R8int i = 0; i < 4; ++i)
+    {
+        if (!_is_range_valid(header, header->coordOffsets[i], streamSize))
+            return R8_FALSE;
+    }
+    for (R8int i = 0; i < 2; ++i)
+    {
+        if (!_is_range_valid(header, header->texCoordOffsets[i], streamSize))
+            return R8_FALSE;
+    }
+
+    return _is_range_valid(header, header->indicesOffset, (size_t)header->numIndices * _index_size(header->indexType));
+}
+
+static R8uint _align_offset(R8uint offset)
+{
+    return (offset + (R8_MESH_FILE_ALIGNMENT - 1)) & ~(R8uint)(R8_MESH_FILE_ALIGNMENT - 1);
+}
+
+// Writes the data at the (aligned) file offset and returns the offset behind the data.
+static R8uint _write_block(FILE* file, R8uint offset, R8uint alignedOffset, const R8void* data, size_t size)
+{
+    static const R8ubyte padding[R8_MESH_FILE_ALIGNMENT] = { 0 };
+
+    fwrite(padding, 1, alignedOffset - offset, file);
+    if (size > 0)
+        fwrite(data, 1, size, file);
+
+    return alignedOffset + (R8uint)size;
+}
+
+// --- interface --- //
+
+R8Mesh* r8_mesh_load(const char* filename)
+{
+    if (filename == NULL)
+    {
+        r8_error_set(R8_ERROR_NULL_POINTER, __FUNCTION__);
+        return NULL;
+    }
+
+    // Map entire file into memory
+    R8FileMapping fileMapping;
+
+    if (!_file_map(&fileMapping, filename))
+    {
+        r8_error_set(R8_ERROR_INVALID_ARGUMENT, __FUNCTION__);
+        return NULL;
+    }
+
+    const R8MeshFileHeader* header = (const R8MeshFileHeader*)fileMapping.data;
+
+    if (!_validate_header(header, fileMapping.size))
+    {
+        _file_unmap(&fileMapping);
+        r8_error_set(R8_ERROR_INVALID_ARGUMENT, __FUNCTION__);
+        return NULL;
+    }
+
+    // Create mesh whose buffers reference the streams in place (no vertex or index is copied or touched here)
+    R8Mesh* mesh = R8_MALLOC(R8Mesh);
+
+    mesh->fileMapping   = fileMapping;
+    mesh->vertexBuffer  = r8_vertexbuffer_create();
+    mesh->indexBuffer   = r8_indexbuffer_create();
+
+    memcpy(mesh->boundsMin, header->boundsMin, sizeof(mesh->boundsMin));
+    memcpy(mesh->boundsMax, header->boundsMax, sizeof(mesh->boundsMax));
+
+    const R8ubyte* base = (const R8ubyte*)fileMapping.data;
+    const R8float* coords[4], * texCoords[2];
+
+    for (R8int i = 0; i < 4; ++i)
+        coords[i] = (const R8float*)(base + header->coordOffsets[i]);
+    for (R8int i = 0; i < 2; ++i)
+        texCoords[i] = (const R8float*)(base + header->texCoordOffsets[i]);
+
+    r8_vertexbuffer_reference(mesh->vertexBuffer, (R8sizei)header->numVertices, coords, texCoords);
+    r8_vertexbuffer_bounds(mesh->vertexBuffer, header->boundsMin, header->boundsMax);
+    r8_indexbuffer_reference(mesh->indexBuffer, base + header->indicesOffset, header->indexType, (R8sizei)header->numIndices);
+
+    r8_ref_add(mesh);
+
+    return mesh;
+}
+
+void r8_mesh_delete(R8Mesh* mesh)
+{
+    if (mesh != NULL)
+    {
+        r8_ref_release(mesh);
+
+        // Release buffers before the memory they reference is unmapped
+        r8_vertexbuffer_delete(mesh->vertexBuffer);
+        r8_indexbuffer_delete(mesh->indexBuffer);
+        _file_unmap(&(mesh->fileMapping));
+
+        R8_FREE(mesh);
+    }
+}
+
+R8boolean r8_mesh_save(const char* filename, const R8VertexBuffer* vertexBuffer, const R8IndexBuffer* indexBuffer)
+{
+    if (filename == NULL || vertexBuffer == NULL)
+    {
+        r8_error_set(R8_ERROR_NULL_POINTER, __FUNCTION__);
+        return R8_FALSE;
+    }
+
+    // Setup header with bounding box
+    R8MeshFileHeader header;
+    memset(&header, 0, sizeof(header));
+
+    const R8sizei numVertices = vertexBuffer->numVertices;
+
+    header.magic        = R8_MESH_FILE_MAGIC;
+    header.version      = R8_MESH_FILE_VERSION;
+    header.numVertices  = (R8uint)numVertices;
+    header.numIndices   = (indexBuffer != NULL ? (R8uint)indexBuffer->numIndices : 0);
+    header.indexType    = (indexBuffer != NULL ? indexBuffer->indexType : R8_UNSIGNED_SHORT);
+
+    for (R8int c = 0; c < 3; ++c)
+    {
+        header.boundsMin[c] = (numVertices > 0 ? FLT_MAX : 0.0f);
+        header.boundsMax[c] = (numVertices > 0 ? -FLT_MAX : 0.0f);
+
+        for (R8sizei i = 0; i < numVertices; ++i)
+        {
+            const R8float x = vertexBuffer->coords[c][i];
+            if (header.boundsMin[c] > x)
+                header.boundsMin[c] = x;
+            if (header.boundsMax[c] < x)
+                header.boundsMax[c] = x;
+        }
+    }
+
+    // Layout all streams behind the header (offsets are 32 bit, so the file must be smaller than 4 GiB)
+    const size_t maxFileSize = sizeof(R8MeshFileHeader) + ((size_t)numVertices * sizeof(R8float) + R8_MESH_FILE_ALIGNMENT) * 6 +
+        (size_t)header.numIndices * _index_size(header.indexType);
+
+    if (maxFileSize > 0xFFFFFFFF)
+    {
+        r8_error_set(R8_ERROR_INVALID_ARGUMENT, __FUNCTION__);
+        return R8_FALSE;
+    }
+
+    const R8uint streamSize = (R8uint)numVertices * sizeof(R8float);
+    const R8uint indicesSize = header.numIndices * _index_size(header.indexType);
+
+    R8uint offset = _align_offset(sizeof(R8MeshFileHeader));
+
+    for (R8int i = 0; i < 4; ++i)
+    {
+        header.coordOffsets[i] = offset;
+        offset = _align_offset(offset + streamSize);
+    }
+    for (R8int i = 0; i < 2; ++i)
+    {
+        header.texCoordOffsets[i] = offset;
+        offset = _align_offset(offset + streamSize);
+    }
+
+    header.indicesOffset    = offset;
+    header.fileSize         = offset + indicesSize;
+
+    // Write header and streams
+    FILE* file = fopen(filename, "wb");
+
+    if (file == NULL)
+    {
+        r8_error_set(R8_ERROR_INVALID_ARGUMENT, __FUNCTION__);
+        return R8_FALSE;
+    }
+
+    offset = _write_block(file, 0, 0, &header, sizeof(header));
+
+    for (R8int i = 0; i < 4; ++i)
+        offset = _write_block(file, offset, header.coordOffsets[i], vertexBuffer->coords[i], streamSize);
+    for (R8int i = 0; i < 2; ++i)
+        offset = _write_block(file, offset, header.texCoordOffsets[i], vertexBuffer->texCoords[i], streamSize);
+
+    _write_block(file, offset, header.indicesOffset, (indexBuffer != NULL ? indexBuffer->indices : NULL), indicesSize);
+
+    R8boolean result = (ferror(file) == 0);
+    fclose(file);
+
+    return result;
+}
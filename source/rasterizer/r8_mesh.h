@@ -0,0 +1,78 @@
+/*
+ * r8_mesh.h
+ *
+ * This file is part of the "R8" (Copyright(c) 2021 by Phani Srikar (Pikachuxxxx))
+ * See "LICENSE.txt" for license information.
+ */
+
+#ifndef R8_MESH_H
+#define R8_MESH_H
+
+
+#include "r8_vertexbuffer.h"
+#include "r8_indexbuffer.h"
+
+#include <stddef.h>
+
+#ifdef _WIN32
+#   include <Windows.h>
+#endif
+
+
+// Magic number of the binary mesh format ("R8MS" in little endian).
+#define R8_MESH_FILE_MAGIC      0x534D3852
+// Version of the binary mesh format. Files with another version are rejected.
+#define R8_MESH_FILE_VERSION    1
+// Alignment (in bytes) of all streams inside a mesh file, so they can be loaded with aligned SIMD instructions.
+#define R8_MESH_FILE_ALIGNMENT  16
+
+
+//! Header of the binary mesh format. All offsets are in bytes from the beginning of the file.
+typedef struct R8MeshFileHeader
+{
+    R8uint  magic;              // Must be R8_MESH_FILE_MAGIC.
+    R8uint  version;            // Must be R8_MESH_FILE_VERSION.
+    R8uint  numVertices;        // Number of vertices in each vertex stream.
+    R8uint  numIndices;         // Number of indices (may be zero).
+    R8uint  indexType;          // Either R8_UNSIGNED_SHORT or R8_UNSIGNED_INT.
+    R8uint  fileSize;           // Size of the entire file.
+    R8float boundsMin[3];       // Minimum of the axis-aligned bounding box of all vertex coordinates.
+    R8float boundsMax[3];       // Maximum of the axis-aligned bounding box of all vertex coordinates.
+    R8uint  coordOffsets[4];    // Offsets of the coordinate streams (X, Y, Z, W).
+    R8uint  texCoordOffsets[2]; // Offsets of the texture-coordinate streams (U, V).
+    R8uint  indicesOffset;      // Offset of the indices.
+    R8uint  reserved;
+}
+R8MeshFileHeader;
+
+//! Read-only memory mapping of an entire file.
+typedef struct R8FileMapping
+{
+    const R8void*   data;
+    size_t          size;
+    #ifdef _WIN32
+    HANDLE          file;
+    HANDLE          mapping;
+    #endif
+}
+R8FileMapping;
+
+//! Mesh whose vertex and index buffers reference a memory mapped mesh file.
+typedef struct R8Mesh
+{
+    R8FileMapping   fileMapping;
+    R8VertexBuffer* vertexBuffer;
+    R8IndexBuffer*  indexBuffer;
+    R8float         boundsMin[3];
+    R8float         boundsMax[3];
+}
+R8Mesh;
+
+
+R8Mesh* r8_mesh_load(const char* filename);
+void r8_mesh_delete(R8Mesh* mesh);
+
+R8boolean r8_mesh_save(const char* filename, const R8VertexBuffer* vertexBuffer, const R8IndexBuffer* indexBuffer);
+
+
+#endif
@@ -0,0 +1,391 @@
+/*
+ * r8_mesh_optimizer.c
+ *
+ * This file is part of the "R8" (Copyright(c) 2021 by Phani Srikar (Pikachuxxxx))
+ * See "LICENSE.txt" for license information.
+ */
+
+#include "r8_mesh_optimizer.h"
+#include "r8_memory.h"
+#include "r8_config.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+
+// --- internals --- //
+
+//! Triangle adjacency of all vertices for the Tipsify algorithm.
+typedef struct R8TipsifyState
+{
+    R8sizei*    adjOffsets;     // Offsets into 'adjTriangles' for each vertex (numVertices + 1 entries).
+    R8sizei*    adjTriangles;   // Indices of all triangles which reference a vertex.
+    R8int*      liveCounts;     // Number of not yet emitted triangles for each vertex.
+    R8int*      cacheTimes;     // Time stamp when each vertex has been put into the cache.
+    R8uint*     deadEnds;       // Stack of recently used vertices.
+    R8sizei     numDeadEnds;
+    R8sizei     cursor;         // Next vertex to check when the dead-end stack is empty.
+    R8sizei     numVertices;
+}
+R8TipsifyState;
+
+//! Cluster of triangles for the overdraw sorting.
+typedef struct R8TriangleCluster
+{
+    R8sizei     first;          // First triangle of the cluster.
+    R8sizei     count;          // Number of triangles in the cluster.
+    R8float     sortKey;        // Clusters with a larger key are drawn first.
+}
+R8TriangleCluster;
+
+static void _tipsify_init(R8TipsifyState* state, const R8uint* indices, R8sizei numIndices, R8sizei numVertices)
+{
+    const R8sizei numTriangles = numIndices / 3;
+
+    state->adjOffsets   = R8_CALLOC(R8sizei, numVertices + 1);
+    state->adjTriangles = R8_CALLOC(R8sizei, numTriangles * 3 + 1);
+    state->liveCounts   = R8_CALLOC(R8int, numVertices);
+    state->cacheTimes   = R8_CALLOC(R8int, numVertices);
+    state->deadEnds     = R8_CALLOC(R8uint, numTriangles * 3 + 1);
+    state->numDeadEnds  = 0;
+    state->cursor       = 0;
+    state->numVertices  = numVertices;
+
+    // Count triangles per vertex and build the adjacency offsets
+    for (R8sizei i = 0; i < numTriangles * 3; ++i)
+        ++state->liveCounts[indices[i]];
+
+    for (R8sizei v = 0; v < numVertices; ++v)
+        state->adjOffsets[v + 1] = state->adjOffsets[v] + state->liveCounts[v];
+
+    // Fill adjacency lists ('cacheTimes' is temporarily used as insertion counter)
+    for (R8sizei t = 0; t < numTriangles; ++t)
+    {
+        for (R8int j = 0; j < 3; ++j)
+        {
+            const R8uint v = indices[t*3 + j];
+            state->adjTriangles[state->adjOffsets[v] + state->cacheTimes[v]++] = t;
+        }
+    }
+
+    memset(state->cacheTimes, 0, sizeof(R8int) * numVertices);
+}
+
+static void _tipsify_release(R8TipsifyState* state)
+{
+    R8_FREE(state->adjOffsets);
+    R8_FREE(state->adjTriangles);
+    R8_FREE(state->liveCounts);
+    R8_FREE(state->cacheTimes);
+    R8_FREE(state->deadEnds);
+}
+
+// Returns the next vertex with live triangles from the dead-end stack or in input order, or -1 if all triangles have been emitted.
+static R8int _tipsify_skip_dead_end(R8TipsifyState* state)
+{
+    while (state->numDeadEnds > 0)
+    {
+        const R8uint v = state->deadEnds[--state->numDeadEnds];
+        if (state->liveCounts[v] > 0)
+            return (R8int)v;
+    }
+
+    for (; state->cursor < state->numVertices; ++state->cursor)
+    {
+        if (state->liveCounts[state->cursor] > 0)
+            return (R8int)state->cursor;
+    }
+
+    return -1;
+}
+
+// Returns the candidate vertex which is expected to stay longest in the cache after its remaining triangles have been emitted.
+static R8int _tipsify_next_vertex(R8TipsifyState* state, R8sizei firstCandidate, R8int timeStamp, R8sizei cacheSize)
+{
+    R8int bestVertex = -1, bestPriority = -1;
+
+    for (R8sizei i = firstCandidate; i < state->numDeadEnds; ++i)
+    {
+        const R8uint v = state->deadEnds[i];
+
+        if (state->liveCounts[v] > 0)
+        {
+            // Vertex would still be in the cache after emitting its fan, prefer the oldest one
+            R8int priority = 0;
+            if (timeStamp - state->cacheTimes[v] + 2 * state->liveCounts[v] <= (R8int)cacheSize)
+                priority = timeStamp - state->cacheTimes[v];
+
+            if (priority > bestPriority)
+            {
+                bestPriority = priority;
+                bestVertex = (R8int)v;
+            }
+        }
+    }
+
+    return bestVertex;
+}
+
+// Sorts clusters by descending key; ties keep their original order.
+static int _compare_clusters(const void* lhs, const void* rhs)
+{
+    const R8TriangleCluster* a = (const R8TriangleCluster*)lhs;
+    const R8TriangleCluster* b = (const R8TriangleCluster*)rhs;
+
+    if (a->sortKey != b->sortKey)
+        return (a->sortKey > b->sortKey ? -1 : 1);
+
+    return (a->first < b->first ? -1 : (a->first > b->first ? 1 : 0));
+}
+
+// Computes the area weighted normal (cross product of the edges) and centroid of the specified triangle.
+static void _triangle_normal_and_centroid(const R8float* coords, const R8uint* tri, R8float* normal, R8float* centroid)
+{
+    const R8float* a = coords + tri[0]*3;
+    const R8float* b = coords + tri[1]*3;
+    const R8float* c = coords + tri[2]*3;
+
+    const R8float e1[3] = { b[0] - a[0], b[1] - a[1], b[2] - a[2] };
+    const R8float e2[3] = { c[0] - a[0], c[1] - a[1], c[2] - a[2] };
+
+    normal[0] = e1[1]*e2[2] - e1[2]*e2[1];
+    normal[1] = e1[2]*e2[0] - e1[0]*e2[2];
+    normal[2] = e1[0]*e2[1] - e1[1]*e2[0];
+
+    for (R8int j = 0; j < 3; ++j)
+        centroid[j] = (a[j] + b[j] + c[j]) / 3.0f;
+}
+
+// Sorts the clusters of triangles front to back: clusters whose normal points away from the mesh center occlude the rest of the mesh.
+static void _sort_clusters_for_overdraw(R8TriangleCluster* clusters, R8sizei numClusters, const R8uint* indices, R8sizei numTriangles, const R8float* coords)
+{
+    // Compute area weighted center of the mesh
+    R8float meshCenter[3] = { 0.0f, 0.0f, 0.0f }, meshArea = 0.0f;
+    R8float normal[3], centroid[3];
+
+    for (R8sizei t = 0; t < numTriangles; ++t)
+    {
+        _triangle_normal_and_centroid(coords, indices + t*3, normal, centroid);
+        const R8float area = sqrtf(normal[0]*normal[0] + normal[1]*normal[1] + normal[2]*normal[2]);
+
+        for (R8int j = 0; j < 3; ++j)
+            meshCenter[j] += centroid[j] * area;
+        meshArea += area;
+    }
+
+    if (meshArea > 0.0f)
+    {
+        for (R8int j = 0; j < 3; ++j)
+            meshCenter[j] /= meshArea;
+    }
+
+    // Compute sort key of each cluster: dot(clusterCenter - meshCenter, clusterNormal)
+    for (R8sizei i = 0; i < numClusters; ++i)
+    {
+        R8float clusterNormal[3] = { 0.0f, 0.0f, 0.0f }, clusterCenter[3] = { 0.0f, 0.0f, 0.0f }, clusterArea = 0.0f;
+
+        for (R8sizei t = clusters[i].first; t < clusters[i].first + clusters[i].count; ++t)
+        {
+            _triangle_normal_and_centroid(coords, indices + t*3, normal, centroid);
+            const R8float area = sqrtf(normal[0]*normal[0] + normal[1]*normal[1] + normal[2]*normal[2]);
+
+            for (R8int j = 0; j < 3; ++j)
+            {
+                clusterNormal[j] += normal[j];
+                clusterCenter[j] += centroid[j] * area;
+            }
+            clusterArea += area;
+        }
+
+        const R8float normalLength = sqrtf(clusterNormal[0]*clusterNormal[0] + clusterNormal[1]*clusterNormal[1] + clusterNormal[2]*clusterNormal[2]);
+
+        clusters[i].sortKey = 0.0f;
+
+        if (clusterArea > 0.0f && normalLength > 0.0f)
+        {
+            for (R8int j = 0; j < 3; ++j)
+                clusters[i].sortKey += (clusterCenter[j] / clusterArea - meshCenter[j]) * clusterNormal[j] / normalLength;
+        }
+    }
+
+    qsort(clusters, (size_t)numClusters, sizeof(R8TriangleCluster), _compare_clusters);
+}
+
+// --- interface --- //
+
+R8float r8_mesh_optimizer_acmr_fifo(const R8uint* indices, R8sizei numIndices, R8sizei numVertices, R8sizei cacheSize)
+{
+    const R8sizei numTriangles = numIndices / 3;
+
+    if (numTriangles == 0)
+        return 0.0f;
+
+    // A vertex is inside the FIFO if less than 'cacheSize' misses happened since it has been inserted
+    R8int* cacheTimes = R8_CALLOC(R8int, numVertices);
+    R8int misses = 0;
+
+    for (R8sizei i = 0; i < numTriangles * 3; ++i)
+    {
+        const R8uint v = indices[i];
+
+        if (cacheTimes[v] == 0 || misses - (cacheTimes[v] - 1) >= (R8int)cacheSize)
+            cacheTimes[v] = ++misses;
+    }
+
+    free(cacheTimes);
+
+    return (R8float)misses / (R8float)numTriangles;
+}
+
+R8float r8_mesh_optimizer_acmr_direct(const R8uint* indices, R8sizei numIndices)
+{
+    const R8sizei numTriangles = numIndices / 3;
+
+    if (numTriangles == 0)
+        return 0.0f;
+
+    R8int entries[R8_VERTEX_CACHE_SIZE];
+    R8int misses = 0;
+
+    for (R8int i = 0; i < R8_VERTEX_CACHE_SIZE; ++i)
+        entries[i] = -1;
+
+    for (R8sizei i = 0; i < numTriangles * 3; ++i)
+    {
+        R8int* entry = &(entries[indices[i] & (R8_VERTEX_CACHE_SIZE - 1)]);
+
+        if (*entry != (R8int)indices[i])
+        {
+            *entry = (R8int)indices[i];
+            ++misses;
+        }
+    }
+
+    return (R8float)misses / (R8float)numTriangles;
+}
+
+void r8_mesh_optimizer_reorder_triangles(
+    R8uint* dstIndices, const R8uint* indices, R8sizei numIndices, R8sizei numVertices, R8sizei cacheSize, const R8float* coords)
+{
+    const R8sizei numTriangles = numIndices / 3;
+
+    if (numTriangles == 0)
+        return;
+
+    R8TipsifyState state;
+    _tipsify_init(&state, indices, numIndices, numVertices);
+
+    R8boolean* emitted = R8_CALLOC(R8boolean, numTriangles);
+    R8uint* output = R8_CALLOC(R8uint, numTriangles * 3);
+    R8TriangleCluster* clusters = R8_CALLOC(R8TriangleCluster, numTriangles);
+
+    R8sizei numOutput = 0, numClusters = 0;
+    R8int timeStamp = (R8int)cacheSize + 1;
+
+    R8int fanVertex = _tipsify_skip_dead_end(&state);
+
+    while (fanVertex >= 0)
+    {
+        const R8sizei firstCandidate = state.numDeadEnds;
+
+        // Emit all remaining triangles around the fanning vertex
+        for (R8sizei i = state.adjOffsets[fanVertex]; i < state.adjOffsets[fanVertex + 1]; ++i)
+        {
+            const R8sizei t = state.adjTriangles[i];
+
+            if (emitted[t])
+                continue;
+
+            for (R8int j = 0; j < 3; ++j)
+            {
+                const R8uint v = indices[t*3 + j];
+
+                output[numOutput*3 + j] = v;
+                state.deadEnds[state.numDeadEnds++] = v;
+                --state.liveCounts[v];
+
+                if (timeStamp - state.cacheTimes[v] > (R8int)cacheSize)
+                    state.cacheTimes[v] = timeStamp++;
+            }
+
+            emitted[t] = R8_TRUE;
+            ++numOutput;
+        }
+
+        // Continue with a vertex of the recently emitted triangles, otherwise a dead-end starts a new cluster
+        fanVertex = _tipsify_next_vertex(&state, firstCandidate, timeStamp, cacheSize);
+
+        if (fanVertex < 0)
+        {
+            fanVertex = _tipsify_skip_dead_end(&state);
+
+            const R8sizei clusterFirst = (numClusters > 0 ? clusters[numClusters - 1].first + clusters[numClusters - 1].count : 0);
+            if (numOutput > clusterFirst)
+            {
+                clusters[numClusters].first = clusterFirst;
+                clusters[numClusters].count = numOutput - clusterFirst;
+                ++numClusters;
+            }
+        }
+    }
+
+    // Every cluster has been closed by a dead-end, now sort them to reduce overdraw
+    if (coords != NULL)
+        _sort_clusters_for_overdraw(clusters, numClusters, output, numOutput, coords);
+
+    R8sizei dst = 0;
+    for (R8sizei i = 0; i < numClusters; ++i)
+    {
+        memcpy(dstIndices + dst*3, output + clusters[i].first*3, sizeof(R8uint) * 3 * clusters[i].count);
+        dst += clusters[i].count;
+    }
+
+    // Keep the trailing indices of an incomplete triangle
+    if (dstIndices != indices)
+    {
+        for (R8sizei i = numTriangles * 3; i < numIndices; ++i)
+            dstIndices[i] = indices[i];
+    }
+
+    free(clusters);
+    free(output);
+    free(emitted);
+    _tipsify_release(&state);
+}
+
+R8sizei r8_mesh_optimizer_reorder_vertices(R8uint* remap, R8uint* indices, R8sizei numIndices, R8sizei numVertices)
+{
+    // Assign new indices in the order of the first use
+    R8uint* newIndices = R8_CALLOC(R8uint, numVertices);
+    R8uint numUsed = 0;
+
+    for (R8sizei v = 0; v < numVertices; ++v)
+        newIndices[v] = 0xFFFFFFFF;
+
+    for (R8sizei i = 0; i < numIndices; ++i)
+    {
+        const R8uint v = indices[i];
+
+        if (newIndices[v] == 0xFFFFFFFF)
+        {
+            newIndices[v] = numUsed;
+            remap[numUsed++] = v;
+        }
+
+        indices[i] = newIndices[v];
+    }
+
+    // Move unreferenced vertices to the end
+    R8uint numRemapped = numUsed;
+
+    for (R8sizei v = 0; v < numVertices; ++v)
+    {
+        if (newIndices[v] == 0xFFFFFFFF)
+            remap[numRemapped++] = (R8uint)v;
+    }
+
+    free(newIndices);
+
+    return (R8sizei)numUsed;
+}
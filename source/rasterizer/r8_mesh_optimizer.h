@@ -0,0 +1,47 @@
+/*
+ * r8_mesh_optimizer.h
+ *
+ * This file is part of the "R8" (Copyright(c) 2021 by Phani Srikar (Pikachuxxxx))
+ * See "LICENSE.txt" for license information.
+ */
+
+#ifndef R8_MESH_OPTIMIZER_H
+#define R8_MESH_OPTIMIZER_H
+
+
+#include "r8_types.h"
+
+
+// Cache size which is assumed by the triangle reordering (typical size of a FIFO post-transform cache).
+#define R8_MESH_OPTIMIZER_CACHE_SIZE    16
+
+
+// Returns the average cache miss ratio (transformed vertices per triangle) of a FIFO post-transform cache with 'cacheSize' entries.
+R8float r8_mesh_optimizer_acmr_fifo(const R8uint* indices, R8sizei numIndices, R8sizei numVertices, R8sizei cacheSize);
+
+// Returns the average cache miss ratio of the direct-mapped post-transform vertex cache of the renderer (see R8_VERTEX_CACHE_SIZE).
+R8float r8_mesh_optimizer_acmr_direct(const R8uint* indices, R8sizei numIndices);
+
+/*
+Reorders the triangles for vertex cache locality with the "Tipsify" algorithm (Sander, Nehab, Barczak 2007) and writes them to 'dstIndices'.
+If 'coords' is not NULL (three floats per vertex), the resulting clusters of triangles are sorted front to back
+(view independent, clusters facing away from the mesh center first) to reduce overdraw. Triangles are assumed to be counter-clockwise.
+*/
+void r8_mesh_optimizer_reorder_triangles(
+    R8uint*         dstIndices,
+    const R8uint*   indices,
+    R8sizei         numIndices,
+    R8sizei         numVertices,
+    R8sizei         cacheSize,
+    const R8float*  coords
+);
+
+/*
+Reorders the vertices in the order of their first use by the indices, which are rewritten in place.
+The old index of each new vertex is stored in 'remap' (which must hold 'numVertices' entries).
+Returns the number of referenced vertices; unreferenced vertices are moved to the end.
+*/
+R8sizei r8_mesh_optimizer_reorder_vertices(R8uint* remap, R8uint* indices, R8sizei numIndices, R8sizei numVertices);
+
+
+#endif
@@ -0,0 +1,245 @@
+/*
+ * r8_meshlet.c
+ *
+ * This file is part of the "R8" (Copyright(c) 2021 by Phani Srikar (Pikachuxxxx))
+ * See "LICENSE.txt" for license information.
+ */
+
+#include "r8_meshlet.h"
+#include "r8_memory.h"
+#include "r8_error.h"
+#include "r8_external_math.h"
+
+#include <stdlib.h>
+#include <math.h>
+#include <float.h>
+
+
+// Normal cones whose angle exceeds acos(R8_MESHLET_MIN_CONE_COS) are not used for culling (too few clusters would be rejected).
+#define R8_MESHLET_MIN_CONE_COS 0.01f
+
+
+// --- internals --- //
+
+static void _fetch_position(R8float* position, const R8VertexBuffer* vertexBuffer, R8uint index)
+{
+    position[0] = vertexBuffer->coords[0][index];
+    position[1] = vertexBuffer->coords[1][index];
+    position[2] = vertexBuffer->coords[2][index];
+}
+
+static void _setup_bounding_sphere(R8Meshlet* meshlet, const R8IndexBuffer* indexBuffer, const R8VertexBuffer* vertexBuffer)
+{
+    R8float minPos[3] = { FLT_MAX, FLT_MAX, FLT_MAX }, maxPos[3] = { -FLT_MAX, -FLT_MAX, -FLT_MAX }, p[3];
+
+    for (R8sizei i = 0; i < meshlet->numIndices; ++i)
+    {
+        _fetch_position(p, vertexBuffer, r8_indexbuffer_get(indexBuffer, meshlet->firstIndex + i));
+
+        for (R8int c = 0; c < 3; ++c)
+        {
+            minPos[c] = R8_MIN(minPos[c], p[c]);
+            maxPos[c] = R8_MAX(maxPos[c], p[c]);
+        }
+    }
+
+    for (R8int c = 0; c < 3; ++c)
+        meshlet->center[c] = (minPos[c] + maxPos[c]) * 0.5f;
+
+    // Sphere around the box center, which encloses all vertices
+    R8float maxDistSq = 0.0f;
+
+    for (R8sizei i = 0; i < meshlet->numIndices; ++i)
+    {
+        _fetch_position(p, vertexBuffer, r8_indexbuffer_get(indexBuffer, meshlet->firstIndex + i));
+
+        const R8float dx = p[0] - meshlet->center[0];
+        const R8float dy = p[1] - meshlet->center[1];
+        const R8float dz = p[2] - meshlet->center[2];
+
+        maxDistSq = R8_MAX(maxDistSq, dx*dx + dy*dy + dz*dz);
+    }
+
+    meshlet->radius = sqrtf(maxDistSq);
+}
+
+// Computes the unit normal of the triangle (counter-clockwise in object space) and returns R8_FALSE if the triangle is degenerate.
+static R8boolean _triangle_normal(R8float* normal, const R8IndexBuffer* indexBuffer, const R8VertexBuffer* vertexBuffer, R8sizei firstIndex)
+{
+    R8float a[3], b[3], c[3];
+
+    _fetch_position(a, vertexBuffer, r8_indexbuffer_get(indexBuffer, firstIndex    ));
+    _fetch_position(b, vertexBuffer, r8_indexbuffer_get(indexBuffer, firstIndex + 1));
+    _fetch_position(c, vertexBuffer, r8_indexbuffer_get(indexBuffer, firstIndex + 2));
+
+    const R8float ab[3] = { b[0] - a[0], b[1] - a[1], b[2] - a[2] };
+    const R8float ac[3] = { c[0] - a[0], c[1] - a[1], c[2] - a[2] };
+
+    normal[0] = ab[1]*ac[2] - ab[2]*ac[1];
+    normal[1] = ab[2]*ac[0] - ab[0]*ac[2];
+    normal[2] = ab[0]*ac[1] - ab[1]*ac[0];
+
+    const R8float len = sqrtf(normal[0]*normal[0] + normal[1]*normal[1] + normal[2]*normal[2]);
+
+    if (len <= 0.0f)
+        return R8_FALSE;
+
+    normal[0] /= len;
+    normal[1] /= len;
+    normal[2] /= len;
+
+    return R8_TRUE;
+}
+
+static void _setup_normal_cone(R8Meshlet* meshlet, const R8IndexBuffer* indexBuffer, const R8VertexBuffer* vertexBuffer)
+{
+    // Disable culling by default
+    meshlet->coneAxis[0] = 0.0f;
+    meshlet->coneAxis[1] = 0.0f;
+    meshlet->coneAxis[2] = 1.0f;
+    meshlet->coneCos = 0.0f;
+    meshlet->coneSin = 1.0f;
+
+    // Average the unit normals (a degenerate triangle has no orientation, so it can't be culled)
+    R8float axis[3] = { 0.0f, 0.0f, 0.0f }, n[3];
+
+    for (R8sizei i = 0; i < meshlet->numIndices; i += 3)
+    {
+        if (!_triangle_normal(n, indexBuffer, vertexBuffer, meshlet->firstIndex + i))
+            return;
+
+        axis[0] += n[0];
+        axis[1] += n[1];
+        axis[2] += n[2];
+    }
+
+    const R8float len = sqrtf(axis[0]*axis[0] + axis[1]*axis[1] + axis[2]*axis[2]);
+
+    if (len <= 0.0f)
+        return;
+
+    axis[0] /= len;
+    axis[1] /= len;
+    axis[2] /= len;
+
+    // Find the largest angle between the axis and a normal
+    R8float minDot = 1.0f;
+
+    for (R8sizei i = 0; i < meshlet->numIndices; i += 3)
+    {
+        _triangle_normal(n, indexBuffer, vertexBuffer, meshlet->firstIndex + i);
+        minDot = R8_MIN(minDot, axis[0]*n[0] + axis[1]*n[1] + axis[2]*n[2]);
+    }
+
+    if (minDot < R8_MESHLET_MIN_CONE_COS)
+        return;
+
+    meshlet->coneAxis[0] = axis[0];
+    meshlet->coneAxis[1] = axis[1];
+    meshlet->coneAxis[2] = axis[2];
+    meshlet->coneCos = minDot;
+    meshlet->coneSin = sqrtf(R8_MAX(0.0f, 1.0f - minDot*minDot));
+}
+
+R8_INLINE R8float _det3(
+    R8float a0, R8float a1, R8float a2,
+    R8float b0, R8float b1, R8float b2,
+    R8float c0, R8float c1, R8float c2)
+{
+    return a0*(b1*c2 - b2*c1) - a1*(b0*c2 - b2*c0) + a2*(b0*c1 - b1*c0);
+}
+
+// --- interface --- //
+
+void r8_meshlet_build(R8IndexBuffer* indexBuffer, const R8VertexBuffer* vertexBuffer)
+{
+    if (indexBuffer == NULL || vertexBuffer == NULL)
+    {
+        R8_ERROR(R8_ERROR_NULL_POINTER);
+        return;
+    }
+
+    r8_indexbuffer_free_meshlets(indexBuffer);
+
+    // All indices must refer to the vertex buffer
+    for (R8sizei i = 0; i < indexBuffer->numIndices; ++i)
+    {
+        if (r8_indexbuffer_get(indexBuffer, i) >= (R8uint)vertexBuffer->numVertices)
+        {
+            R8_ERROR(R8_ERROR_INDEX_OUT_OF_BOUNDS);
+            return;
+        }
+    }
+
+    const R8sizei numIndices = indexBuffer->numIndices - indexBuffer->numIndices % 3;
+    const R8sizei numMeshlets = (numIndices + R8_MESHLET_INDICES - 1) / R8_MESHLET_INDICES;
+
+    if (numMeshlets == 0)
+        return;
+
+    // Split triangles into consecutive clusters
+    R8Meshlet* meshlets = R8_CALLOC(R8Meshlet, numMeshlets);
+
+    for (R8sizei i = 0; i < numMeshlets; ++i)
+    {
+        R8Meshlet* meshlet = &(meshlets[i]);
+
+        meshlet->firstIndex = i * R8_MESHLET_INDICES;
+        meshlet->numIndices = R8_MIN(R8_MESHLET_INDICES, numIndices - meshlet->firstIndex);
+
+        _setup_bounding_sphere(meshlet, indexBuffer, vertexBuffer);
+        _setup_normal_cone(meshlet, indexBuffer, vertexBuffer);
+    }
+
+    indexBuffer->meshlets               = meshlets;
+    indexBuffer->numMeshlets            = numMeshlets;
+    indexBuffer->meshletVertexBuffer    = vertexBuffer;
+    indexBuffer->meshletGeneration      = vertexBuffer->generation;
+}
+
+void r8_meshlet_camera(R8float* camera, const R8Matrix4* worldViewProjectionMatrix)
+{
+    // Rows X, Y, and W of the matrix (a clip space component is the dot product of its row with (x, y, z, 1))
+    const R8float (*m)[4] = worldViewProjectionMatrix->m;
+
+    const R8float x[4] = { m[0][0], m[1][0], m[2][0], m[3][0] };
+    const R8float y[4] = { m[0][1], m[1][1], m[2][1], m[3][1] };
+    const R8float w[4] = { m[0][3], m[1][3], m[2][3], m[3][3] };
+
+    /*
+    The camera is the point which is projected onto every pixel, i.e. X = Y = W = 0.
+    Its signed cofactors also give the orientation of a projected triangle: the determinant of the clip coordinates (X, Y, W)
+    of three vertices equals dot(plane, camera), where 'plane' is the triangle plane (N, -dot(N, P)).
+    */
+    camera[0] =  _det3(x[1], x[2], x[3], y[1], y[2], y[3], w[1], w[2], w[3]);
+    camera[1] = -_det3(x[0], x[2], x[3], y[0], y[2], y[3], w[0], w[2], w[3]);
+    camera[2] =  _det3(x[0], x[1], x[3], y[0], y[1], y[3], w[0], w[1], w[3]);
+    camera[3] = -_det3(x[0], x[1], x[2], y[0], y[1], y[2], w[0], w[1], w[2]);
+}
+
+R8boolean r8_meshlet_backfacing(const R8Meshlet* meshlet, const R8float* camera, R8float facing)
+{
+    if (meshlet->coneCos <= 0.0f)
+        return R8_FALSE;
+
+    // Direction from the sphere center to the camera (scaled by the camera's W component)
+    const R8float u[3] =
+    {
+        facing * (camera[0] - meshlet->center[0] * camera[3]),
+        facing * (camera[1] - meshlet->center[1] * camera[3]),
+        facing * (camera[2] - meshlet->center[2] * camera[3]),
+    };
+
+    const R8float lenSq = u[0]*u[0] + u[1]*u[1] + u[2]*u[2];
+    const R8float axisDist = u[0]*meshlet->coneAxis[0] + u[1]*meshlet->coneAxis[1] + u[2]*meshlet->coneAxis[2];
+    const R8float perpDist = sqrtf(R8_MAX(0.0f, lenSq - axisDist*axisDist));
+
+    /*
+    Smallest dot product of 'u' with any normal inside the cone (the cosine of the angle to 'u' plus the cone angle),
+    which must exceed the largest offset of a triangle plane from the sphere center.
+    The last term is a tolerance for rounding errors, so triangles which are seen edge-on are never rejected.
+    */
+    const R8float minDot = axisDist * meshlet->coneCos - perpDist * meshlet->coneSin;
+
+    return (minDot > meshlet->radius * fabsf(camera[3]) + sqrtf(lenSq) * 1.0e-4f);
+}
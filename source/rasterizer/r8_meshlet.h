@@ -0,0 +1,56 @@
+/*
+ * r8_meshlet.h
+ *
+ * This file is part of the "R8" (Copyright(c) 2021 by Phani Srikar (Pikachuxxxx))
+ * See "LICENSE.txt" for license information.
+ */
+
+#ifndef R8_MESHLET_H
+#define R8_MESHLET_H
+
+
+#include "r8_indexbuffer.h"
+#include "r8_vertexbuffer.h"
+#include "r8_matrix4.h"
+
+
+// Number of triangles per meshlet (the last meshlet of an index buffer can have less).
+#define R8_MESHLET_TRIANGLES    64
+#define R8_MESHLET_INDICES      (R8_MESHLET_TRIANGLES * 3)
+
+
+//! Cluster of consecutive triangles of an index buffer with bounding sphere and normal cone.
+typedef struct R8Meshlet
+{
+    R8sizei firstIndex;     // First index of the meshlet in the index buffer.
+    R8sizei numIndices;     // Number of indices (three per triangle).
+    R8float center[3];      // Center of the bounding sphere.
+    R8float radius;         // Radius of the bounding sphere.
+    R8float coneAxis[3];    // Average direction of the triangle normals (unit length).
+    R8float coneCos;        // Cosine of the cone angle, which encloses all triangle normals. Zero if the normals don't fit into a cone (no backface culling).
+    R8float coneSin;        // Sine of the cone angle.
+}
+R8Meshlet;
+
+
+/*
+Splits the index buffer into meshlets of R8_MESHLET_TRIANGLES consecutive triangles (in the order of the index buffer,
+so triangles should be sorted for locality first, e.g. with the mesh optimizer) and stores them in the index buffer.
+The meshlets are only used while drawing with the same vertex buffer and become invalid when the index data is replaced.
+*/
+void r8_meshlet_build(R8IndexBuffer* indexBuffer, const R8VertexBuffer* vertexBuffer);
+
+/*
+Computes the camera position in object space as homogeneous coordinate (the null vector of the X, Y, and W rows of the matrix),
+so it works for perspective and orthogonal projections (where W is zero).
+*/
+void r8_meshlet_camera(R8float* camera, const R8Matrix4* worldViewProjectionMatrix);
+
+/*
+Returns R8_TRUE if all triangles of the meshlet are culled for the camera (see 'r8_meshlet_camera').
+A triangle with normal N (counter-clockwise in object space) and vertex P is culled if 'facing' * dot(N, camera.xyz - P*camera.w) > 0.
+*/
+R8boolean r8_meshlet_backfacing(const R8Meshlet* meshlet, const R8float* camera, R8float facing);
+
+
+#endif
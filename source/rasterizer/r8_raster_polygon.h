@@ -0,0 +1,36 @@
+/*
+ * r8_raster_polygon.h
+ *
+ * This file is part of the "R8" (Copyright(c) 2021 by Phani Srikar (Pikachuxxxx))
+ * See "LICENSE.txt" for license information.
+ */
+
+#ifndef R8_RASTER_POLYGON_H
+#define R8_RASTER_POLYGON_H
+
+
+#include "r8_raster_vertex.h"
+#include "r8_color.h"
+#include "r8_rect.h"
+
+
+//! Clipped and r8ojected convex polygon, ready to be rasterized.
+typedef struct R8RasterPolygon
+{
+    const R8RasterVertex*   vertices;       // Polygon vertices (in screen space).
+    R8int                   numVertices;    // Number of polygon vertices.
+    R8enum                  polygonMode;    // R8_POLYGON_FILL, R8_POLYGON_LINE or R8_POLYGON_POINT.
+    R8boolean               halfSpace;      // Fill polygon with the half-space rasterizer instead of scanlines.
+    R8boolean               hierarchicalZ;  // Test polygon against the Hi-Z tiles before its pixels are rasterized.
+    const R8ColorBuffer*    texels;         // Texels of the selected MIP level. Null for single colored polygons.
+    R8texsize               mipWidth;       // Width of the selected MIP level.
+    R8texsize               mipHeight;      // Height of the selected MIP level.
+    R8boolean               mipPow2;        // Selected MIP level is sampled with fixed-point texel coordinates and bit masks.
+    R8ubyte                 mipWidthShift;  // Binary logarithm of the MIP level width (only for power-of-two MIP levels).
+    R8ColorBuffer           colorIndex;     // Color for single colored polygons and polygon points.
+    R8Rect                  clipRect;       // Clipping rectangle (inclusive). Polygons inside the guard band can exceed it, so the rasterizers clamp to it.
+}
+R8RasterPolygon;
+
+
+#endif
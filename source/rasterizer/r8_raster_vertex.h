@@ -12,6 +12,10 @@
 #include "r8_types.h"
 
 
+// Number of fractional bits of the sub-pixel screen coordinates
+#define R8_SUBPIXEL_BITS 4
+
+
 //! Raster vertex structure before r8ojection (for clipping)
 typedef struct R8ClipVertex
 {
@@ -27,11 +31,13 @@ R8ClipVertex;
 //! Raster vertex structure after r8ojection
 typedef struct R8RasterVertex
 {
-    R8int       x; // Screen coordinate X.
-    R8int       y; // Screen coordinate Y.
-    R8interp    z; // Normalized device coordinate Z.
-    R8interp    u; // Inverse texture coordinate U.
-    R8interp    v; // Inverse texture coordinate V.
+    R8int       x;      // Screen coordinate X.
+    R8int       y;      // Screen coordinate Y.
+    R8int       subX;   // Sub-pixel screen coordinate X (fixed-point with R8_SUBPIXEL_BITS fractional bits).
+    R8int       subY;   // Sub-pixel screen coordinate Y (fixed-point with R8_SUBPIXEL_BITS fractional bits).
+    R8interp    z;      // Normalized device coordinate Z.
+    R8interp    u;      // Inverse texture coordinate U.
+    R8interp    v;      // Inverse texture coordinate V.
 }
 R8RasterVertex;
 
@@ -10,12 +10,17 @@
 #include "r8_state_machine.h"
 #include "r8_global_state.h"
 #include "r8_raster_triangle.h"
+#include "r8_tile_binner.h"
+#include "r8_halfspace.h"
+#include "r8_thread.h"
 #include "r8_external_math.h"
 #include "r8_matrix4.h"
+#include "r8_meshlet.h"
 #include "r8_error.h"
 #include "r8_config.h"
 
 #include <stdio.h>
+#include <string.h>
 #include <math.h>
 
 
@@ -29,31 +34,98 @@ static R8int _numPolyVerts = 0;
 
 #define _CVERT_VEC2(v) (*(R8Vector2*)(&((_clipVertices[v]).x)))
 
-static void _vertexbuffer_transform(R8sizei numVertices, R8sizei firstVertex, R8VertexBuffer* vertexBuffer)
+//! Entry of the direct-mapped post-transform vertex cache.
+typedef struct R8VertexCacheEntry
 {
-    r8_vertexbuffer_transform(
+    R8int           index;  // Vertex index of the cached vertex or -1 if the entry is empty.
+    R8ClipVertex    vertex; // Transformed vertex (before clipping).
+}
+R8VertexCacheEntry;
+
+static R8VertexCacheEntry _vertexCache[R8_VERTEX_CACHE_SIZE];
+static R8int _vertexCacheHits = 0, _vertexCacheMisses = 0;
+
+// Transforms the vertices [firstVertex, firstVertex + numVertices) in a batch into the clip stream of the current draw call.
+static void _transform_vertices(R8sizei numVertices, R8sizei firstVertex, const R8VertexBuffer* vertexBuffer)
+{
+    r8_clipstream_reserve(&R8_CLIP_STREAM, numVertices);
+    r8_vertexbuffer_transform_batch(
+        &R8_CLIP_STREAM,
+        vertexBuffer,
         numVertices,
         firstVertex,
-        vertexBuffer,
-        &(R8_STATE_MACHINE.worldViewProjectionMatrix),
-        &(R8_STATE_MACHINE.viewport)
+        &(R8_STATE_MACHINE.worldViewProjectionMatrix)
     );
 }
 
-static void _vertexbuffer_transform_all(R8VertexBuffer* vertexBuffer)
+// Fetches the transformed vertex at 'streamIndex' from the clip stream and the texture coordinates of the vertex 'index'.
+static void _fetch_vertex(R8ClipVertex* clipVert, const R8VertexBuffer* vertexBuffer, R8sizei streamIndex, R8sizei index)
 {
-    r8_vertexbuffer_transform_all(
-        vertexBuffer,
-        &(R8_STATE_MACHINE.worldViewProjectionMatrix),
-        &(R8_STATE_MACHINE.viewport)
-    );
+    clipVert->x = R8_CLIP_STREAM.coords[0][streamIndex];
+    clipVert->y = R8_CLIP_STREAM.coords[1][streamIndex];
+    clipVert->z = R8_CLIP_STREAM.coords[2][streamIndex];
+    clipVert->w = R8_CLIP_STREAM.coords[3][streamIndex];
+    clipVert->u = vertexBuffer->texCoords[0][index];
+    clipVert->v = vertexBuffer->texCoords[1][index];
+}
+
+static void _transform_vertex(R8ClipVertex* clipVert, const R8VertexBuffer* vertexBuffer, R8sizei index)
+{
+    r8_vertexbuffer_transform_vertex(&(clipVert->x), vertexBuffer, index, &(R8_STATE_MACHINE.worldViewProjectionMatrix));
+    clipVert->u = vertexBuffer->texCoords[0][index];
+    clipVert->v = vertexBuffer->texCoords[1][index];
+}
+
+// Returns R8_TRUE if the bounding volume of the vertex buffer is entirely outside of the view volume, so the draw call can be skipped entirely.
+static R8boolean _is_draw_culled(const R8VertexBuffer* vertexBuffer)
+{
+    if (!vertexBuffer->hasBounds)
+        return R8_FALSE;
+
+    R8Frustum frustum;
+    r8_frustum_setup(&frustum, &(R8_STATE_MACHINE.worldViewProjectionMatrix), R8_STATE_MACHINE.clipBounds);
+
+    if (r8_frustum_cull_bounds(&frustum, &(vertexBuffer->bounds)))
+    {
+        ++R8_STATE_MACHINE.boundFrameBuffer->culledDraws;
+        return R8_TRUE;
+    }
+
+    return R8_FALSE;
+}
+
+// Invalidates the post-transform vertex cache, because the transformation can change between draw calls.
+static void _vertex_cache_reset()
+{
+    for (R8int i = 0; i < R8_VERTEX_CACHE_SIZE; ++i)
+        _vertexCache[i].index = -1;
+
+    _vertexCacheHits = 0;
+    _vertexCacheMisses = 0;
+}
+
+// Stores the transformed vertex with the specified index in 'clipVert'. The vertex is only transformed if it's not in the cache.
+static void _vertex_cache_fetch(R8ClipVertex* clipVert, const R8VertexBuffer* vertexBuffer, R8int index)
+{
+    R8VertexCacheEntry* entry = &(_vertexCache[index & (R8_VERTEX_CACHE_SIZE - 1)]);
+
+    if (entry->index != index)
+    {
+        _transform_vertex(&(entry->vertex), vertexBuffer, index);
+        entry->index = index;
+        ++_vertexCacheMisses;
+    }
+    else
+        ++_vertexCacheHits;
+
+    *clipVert = entry->vertex;
 }
 
-static void _transform_vertex(R8ClipVertex* clipVert, const R8Vertex* vert)
+// Adds the vertex cache statistics of the current draw call to the specified frame buffer.
+static void _vertex_cache_submit_statistics(R8FrameBuffer* frameBuffer)
 {
-    r8_matrix_mul_float4(&(clipVert->x), &(R8_STATE_MACHINE.worldViewProjectionMatrix), &(vert->coord.x));
-    clipVert->u = vert->texCoord.x;
-    clipVert->v = vert->texCoord.y;
+    frameBuffer->vertexCacheHits += _vertexCacheHits;
+    frameBuffer->vertexCacheMisses += _vertexCacheMisses;
 }
 
 static void _r8oject_vertex(R8ClipVertex* vertex, const R8Viewport* viewport)
@@ -81,8 +153,11 @@ static void _r8oject_vertex(R8ClipVertex* vertex, const R8Viewport* viewport)
 
 static void _setup_raster_vertex(R8RasterVertex* rasterVert, const R8ClipVertex* clipVert)
 {
-    rasterVert->x = (R8int)(clipVert->x);
-    rasterVert->y = (R8int)(clipVert->y);
+    // Round down (instead of toward zero), because vertices inside the guard band can have negative screen coordinates
+    rasterVert->x = (R8int)floorf(clipVert->x);
+    rasterVert->y = (R8int)floorf(clipVert->y);
+    rasterVert->subX = (R8int)floorf(clipVert->x * (1 << R8_SUBPIXEL_BITS));
+    rasterVert->subY = (R8int)floorf(clipVert->y * (1 << R8_SUBPIXEL_BITS));
     rasterVert->z = clipVert->z;
     rasterVert->u = clipVert->u;
     rasterVert->v = clipVert->v;
@@ -109,10 +184,44 @@ static R8boolean _is_triangle_culled(const R8Vector2 a, const R8Vector2 b, const
     return R8_FALSE;
 }
 
+// Applies the pending clears of the frame buffer inside the specified rectangle (inclusive), before its pixels are accessed.
+static void _resolve_rect(R8FrameBuffer* frameBuffer, R8int left, R8int top, R8int right, R8int bottom)
+{
+    R8Rect rect;
+
+    rect.left   = left;
+    rect.top    = top;
+    rect.right  = right;
+    rect.bottom = bottom;
+
+    r8_framebuffer_resolve(frameBuffer, &rect);
+}
+
+// Returns the signed distance of the vertex to the homogeneous clipping plane (non-negative if the vertex is inside).
+R8_INLINE R8float _clipplane_distance(const R8ClipVertex* vertex, const R8float* plane)
+{
+    return vertex->x * plane[0] + vertex->y * plane[1] + vertex->z * plane[2] + vertex->w * plane[3];
+}
+
+// Returns the primitive restart index for the index type of the specified index buffer (the largest index value).
+R8_INLINE R8uint _primitive_restart_index(const R8IndexBuffer* indexBuffer)
+{
+    return (indexBuffer->indexType == R8_UNSIGNED_INT ? 0xFFFFFFFFu : 0xFFFFu);
+}
+
+// Returns R8_TRUE if the range [first, first + count) lies inside a buffer with 'size' elements (the sum is never computed, so it can not overflow).
+R8_INLINE R8boolean _is_valid_range(R8sizei first, R8sizei count, R8sizei size)
+{
+    return (first >= 0 && count >= 0 && first <= size - count);
+}
+
 // --- points --- //
 
 void r8_render_screenspace_point(R8int x, R8int y)
 {
+    // Binned polygons must be rasterized first
+    r8_tile_binner_flush();
+
     // Validate bound frame buffer
     R8FrameBuffer* frameBuffer = R8_STATE_MACHINE.boundFrameBuffer;
 
@@ -134,11 +243,14 @@ void r8_render_screenspace_point(R8int x, R8int y)
     #endif
 
     // Plot screen space point
+    _resolve_rect(frameBuffer, x, y, x, y);
     r8_framebuffer_plot(frameBuffer, x, y, R8_STATE_MACHINE.color0);
 }
 
-void r8_render_points(R8sizei numVertices, R8sizei firstVertex, /*const */R8VertexBuffer* vertexBuffer)
+void r8_render_points(R8sizei numVertices, R8sizei firstVertex, const R8VertexBuffer* vertexBuffer)
 {
+    r8_tile_binner_flush();
+
     // Validate bound frame buffer
     R8FrameBuffer* frameBuffer = R8_STATE_MACHINE.boundFrameBuffer;
 
@@ -155,30 +267,39 @@ void r8_render_points(R8sizei numVertices, R8sizei firstVertex, /*const */R8Vert
         return;
     }
 
-    if (firstVertex + numVertices >= vertexBuffer->numVertices)
+    if (!_is_valid_range(firstVertex, numVertices, vertexBuffer->numVertices))
     {
         R8_ERROR(R8_ERROR_INVALID_ARGUMENT);
         return;
     }
 
-    // Transform vertices
-    _vertexbuffer_transform(numVertices, firstVertex, vertexBuffer);
+    if (_is_draw_culled(vertexBuffer))
+        return;
+
+    r8_framebuffer_resolve(frameBuffer, NULL);
 
     // Render points
-    R8Vertex* vert;
+    R8ClipVertex vert;
 
     R8uint x, y;
     R8uint width = frameBuffer->width, height = frameBuffer->height;
 
-    for (; firstVertex < numVertices; ++firstVertex)
+    for (R8sizei i = 0; i < numVertices; ++i)
     {
-        vert = (vertexBuffer->vertices + firstVertex);
+        // Transform vertices in batches of bounded size
+        const R8sizei batchIndex = i % R8_MAX_BATCH_VERTICES;
+
+        if (batchIndex == 0)
+            _transform_vertices(R8_MIN(numVertices - i, R8_MAX_BATCH_VERTICES), firstVertex + i, vertexBuffer);
 
-        x = (R8uint)(vert->ndc.x);
+        _fetch_vertex(&vert, vertexBuffer, batchIndex, firstVertex + i);
+        _r8oject_vertex(&vert, &(R8_STATE_MACHINE.viewport));
+
+        x = (R8uint)(vert.x);
         #ifdef R8_ORIGIN_LEFT_TOP
-        y = frameBuffer->height - (R8uint)(vert->ndc.y) - 1;
+        y = frameBuffer->height - (R8uint)(vert.y) - 1;
         #else
-        y = (R8uint)(vert->ndc.y);
+        y = (R8uint)(vert.y);
         #endif
 
         if (x < width && y < height)
@@ -193,22 +314,40 @@ void r8_render_indexed_points(R8sizei numVertices, R8sizei firstVertex, const R8
 
 // --- lines --- //
 
-// This function implements the line "bresenham" algorithm.
-static void _render_screenspace_line_colored(R8int x1, R8int y1, R8int x2, R8int y2)
+// Line of the "Bresenham" algorithm, whose steps are clipped against a rectangle (see '_setup_line')
+typedef struct R8RasterLine
 {
-    // Get bound frame buffer
-    R8FrameBuffer* frameBuffer = R8_STATE_MACHINE.boundFrameBuffer;
+    R8int   x;          // Pixel coordinate X of the first step inside the rectangle
+    R8int   y;          // Pixel coordinate Y of the first step inside the rectangle
+    R8int   err;        // Error term at the first step
+    R8int   pdx;        // Straight step X
+    R8int   pdy;        // Straight step Y
+    R8int   ddx;        // Diagonal step X
+    R8int   ddy;        // Diagonal step Y
+    R8int   es;         // Extent along the short axis
+    R8int   el;         // Extent along the long axis (number of steps of the unclipped line)
+    R8int   lastX;      // Pixel coordinate X of the last step inside the rectangle
+    R8int   lastY;      // Pixel coordinate Y of the last step inside the rectangle
+    R8int   first;      // Index of the first step inside the rectangle
+    R8int   numPixels;  // Number of steps inside the rectangle
+}
+R8RasterLine;
 
-    if ( x1 < 0 || x1 >= (R8int)frameBuffer->width ||
-         x2 < 0 || x2 >= (R8int)frameBuffer->width ||
-         y1 < 0 || y1 >= (R8int)frameBuffer->height ||
-         y2 < 0 || y2 >= (R8int)frameBuffer->height )
-    {
-        R8_ERROR(R8_ERROR_INVALID_ARGUMENT);
-        return;
-    }
+// Returns the number of diagonal steps of a line before the specified step 't' (with 'h' being half the long extent).
+R8_INLINE R8int _line_diagonal_steps(R8int t, R8int es, R8int el, R8int h)
+{
+    return (t*es > h ? (t*es - h + el - 1)/el : 0);
+}
 
-    // Pre-compuations
+/*
+Sets up the line from (x1, y1) to (x2, y2) and clips its steps against the rectangle (inclusive). Returns R8_FALSE if no pixel is inside.
+The clipped line renders exactly the pixels of the unclipped line which are inside the rectangle, i.e. the first step and the error term
+are computed in closed form instead of stepping over the pixels outside. The end point is excluded, so connected lines don't overlap.
+The coordinates must lie inside the guard band (see R8_GUARD_BAND_SIZE), so that the products of the extents don't overflow.
+*/
+static R8boolean _setup_line(R8RasterLine* line, R8int x1, R8int y1, R8int x2, R8int y2, const R8Rect* rect)
+{
+    // Pre-computations
     int dx = x2 - x1;
     int dy = y2 - y1;
 
@@ -220,65 +359,305 @@ static void _render_screenspace_line_colored(R8int x1, R8int y1, R8int x2, R8int
     if (dy < 0)
         dy = -dy;
 
-    int pdx, pdy, ddx, ddy, es, el;
+    // Start, increment, and rectangle range of the long axis (l) and short axis (s)
+    R8int l0, lInc, lMin, lMax, s0, sInc, sMin, sMax;
 
     if (dx > dy)
     {
-        pdx = incx;
-        pdy = 0;
-        ddx = incx;
-        ddy = incy;
-        es  = dy;
-        el  = dx;
+        line->pdx = incx;
+        line->pdy = 0;
+        line->es  = dy;
+        line->el  = dx;
+
+        l0 = x1; lInc = incx; lMin = rect->left; lMax = rect->right;
+        s0 = y1; sInc = incy; sMin = rect->top;  sMax = rect->bottom;
     }
     else
     {
-        pdx = 0;
-        pdy = incy;
-        ddx = incx;
-        ddy = incy;
-        es  = dx;
-        el  = dy;
+        line->pdx = 0;
+        line->pdy = incy;
+        line->es  = dx;
+        line->el  = dy;
+
+        l0 = y1; lInc = incy; lMin = rect->top;  lMax = rect->bottom;
+        s0 = x1; sInc = incx; sMin = rect->left; sMax = rect->right;
     }
 
+    line->ddx = incx;
+    line->ddy = incy;
+
+    const R8int es = line->es, el = line->el, h = el/2;
+
     if (el == 0)
+        return R8_FALSE;
+
+    // Clip steps against the rectangle range of the long axis, which advances one pixel per step
+    R8int first = R8_MAX(0,      (lInc > 0 ? lMin - l0 : l0 - lMax));
+    R8int last  = R8_MIN(el - 1, (lInc > 0 ? lMax - l0 : l0 - lMin));
+
+    /*
+    Clip steps against the rectangle range of the short axis. The number of diagonal steps before step 't' is k(t) = ceil((t*es - h)/el),
+    because the error term h - t*es + k(t)*el always stays inside [0, el). Solve k(t) >= kMin and k(t) <= kMax for 't'.
+    */
+    if (es == 0)
+    {
+        if (s0 < sMin || s0 > sMax)
+            return R8_FALSE;
+    }
+    else
+    {
+        const R8int kMin = (sInc > 0 ? sMin - s0 : s0 - sMax);
+        const R8int kMax = (sInc > 0 ? sMax - s0 : s0 - sMin);
+
+        if (kMax < 0)
+            return R8_FALSE;
+        if (kMin > 0)
+            first = R8_MAX(first, ((kMin - 1)*el + h)/es + 1);
+
+        last = R8_MIN(last, (kMax*el + h)/es);
+    }
+
+    if (first > last)
+        return R8_FALSE;
+
+    // Compute pixels at the first and last step, and the error term at the first step
+    const R8int kFirst = _line_diagonal_steps(first, es, el, h);
+    const R8int kLast = _line_diagonal_steps(last, es, el, h);
+
+    line->x         = x1 + (line->pdx != 0 ? incx*first : incx*kFirst);
+    line->y         = y1 + (line->pdy != 0 ? incy*first : incy*kFirst);
+    line->lastX     = x1 + (line->pdx != 0 ? incx*last : incx*kLast);
+    line->lastY     = y1 + (line->pdy != 0 ? incy*last : incy*kLast);
+    line->err       = h - first*es + kFirst*el;
+    line->first     = first;
+    line->numPixels = last - first + 1;
+
+    return R8_TRUE;
+}
+
+/*
+Clips the screen space line from (x1, y1) to (x2, y2) against the rectangle (inclusive) with the "Liang-Barsky" algorithm,
+and rounds the clipped end points to pixels. Returns R8_FALSE if the line is entirely outside.
+*/
+static R8boolean _clip_screenspace_line(R8int* x1, R8int* y1, R8int* x2, R8int* y2, const R8Rect* rect)
+{
+    const R8float xa = (R8float)*x1, ya = (R8float)*y1;
+    const R8float dx = (R8float)*x2 - xa;
+    const R8float dy = (R8float)*y2 - ya;
+
+    // Distances of the start point to the rectangle sides and their change along the line
+    const R8float q[4] = { xa - rect->left, rect->right - xa, ya - rect->top, rect->bottom - ya };
+    const R8float p[4] = { -dx, dx, -dy, dy };
+
+    R8float t0 = 0.0f, t1 = 1.0f;
+
+    for (R8int i = 0; i < 4; ++i)
+    {
+        if (p[i] == 0.0f)
+        {
+            // Line is parallel to this side and outside
+            if (q[i] < 0.0f)
+                return R8_FALSE;
+        }
+        else
+        {
+            const R8float t = q[i] / p[i];
+            if (p[i] < 0.0f)
+                t0 = R8_MAX(t0, t);
+            else
+                t1 = R8_MIN(t1, t);
+        }
+    }
+
+    if (t0 > t1)
+        return R8_FALSE;
+
+    if (t1 < 1.0f)
+    {
+        *x2 = R8_CLAMP((R8int)floorf(xa + dx*t1 + 0.5f), rect->left, rect->right);
+        *y2 = R8_CLAMP((R8int)floorf(ya + dy*t1 + 0.5f), rect->top, rect->bottom);
+    }
+    if (t0 > 0.0f)
+    {
+        *x1 = R8_CLAMP((R8int)floorf(xa + dx*t0 + 0.5f), rect->left, rect->right);
+        *y1 = R8_CLAMP((R8int)floorf(ya + dy*t0 + 0.5f), rect->top, rect->bottom);
+    }
+
+    return R8_TRUE;
+}
+
+// Applies the pending clears of the frame buffer inside the bounding rectangle of the clipped line.
+static void _resolve_line(R8FrameBuffer* frameBuffer, const R8RasterLine* line)
+{
+    _resolve_rect(
+        frameBuffer,
+        R8_MIN(line->x, line->lastX), R8_MIN(line->y, line->lastY),
+        R8_MAX(line->x, line->lastX), R8_MAX(line->y, line->lastY)
+    );
+}
+
+/*
+Rasterizes the clipped line with a single color.
+Horizontal lines are filled as one span and vertical lines are stored with the row pitch, because they need no error term.
+*/
+static void _rasterize_line_colored(R8FrameBuffer* frameBuffer, const R8RasterLine* line, R8ColorBuffer colorIndex)
+{
+    #ifndef R8_TILED_FRAMEBUFFER
+
+    if (line->es == 0)
+    {
+        if (line->pdy == 0)
+        {
+            // Fill horizontal line as one span of the color plane
+            const R8int offset = r8_framebuffer_index(frameBuffer, R8_MIN(line->x, line->lastX), line->y);
+
+            #ifdef R8_MERGE_COLOR_AND_DEPTH_BUFFERS
+            for (R8int i = 0; i < line->numPixels; ++i)
+                R8_FRAMEBUFFER_COLOR(frameBuffer, offset + i) = colorIndex;
+            #else
+            memset(&(frameBuffer->colors[offset]), colorIndex, (size_t)line->numPixels);
+            #endif
+        }
+        else
+        {
+            // Store vertical line with the row pitch
+            const R8int pitch = line->pdy * (R8int)frameBuffer->width;
+            R8int offset = r8_framebuffer_index(frameBuffer, line->x, line->y);
+
+            for (R8int i = 0; i < line->numPixels; ++i, offset += pitch)
+                R8_FRAMEBUFFER_COLOR(frameBuffer, offset) = colorIndex;
+        }
         return;
+    }
 
-    int x   = x1;
-    int y   = y1;
-    int err = el/2;
+    #endif
+
+    const R8int es = line->es, el = line->el;
+
+    R8int x   = line->x;
+    R8int y   = line->y;
+    R8int err = line->err;
 
     // Render each pixel of the line
-    for (int t = 0; t < el; ++t)
+    for (R8int t = 0; t < line->numPixels; ++t)
     {
         // Render pixel
-        r8_framebuffer_plot(R8_STATE_MACHINE.boundFrameBuffer, (R8uint)x, (R8uint)y, R8_STATE_MACHINE.color0);
+        r8_framebuffer_plot(frameBuffer, (R8uint)x, (R8uint)y, colorIndex);
 
         // Move to next pixel
         err -= es;
         if (err < 0)
         {
             err += el;
-            x += ddx;
-            y += ddy;
+            x += line->ddx;
+            y += line->ddy;
         }
         else
         {
-            x += pdx;
-            y += pdy;
+            x += line->pdx;
+            y += line->pdy;
+        }
+    }
+}
+
+/*
+Rasterizes the clipped line from 'a' to 'b' with depth test. Lines are colored with 'colorIndex' if 'texels' is null.
+Depth and texture coordinates are interpolated linearly in screen space, because the raster vertices store the inverse 'w'
+and the texture coordinates divided by 'w' (see '_r8oject_vertex').
+*/
+static void _rasterize_line_depth(
+    R8FrameBuffer* frameBuffer, const R8RasterLine* line, const R8RasterVertex* a, const R8RasterVertex* b,
+    const R8ColorBuffer* texels, R8texsize mipWidth, R8texsize mipHeight, R8ColorBuffer colorIndex, R8boolean hierarchicalZ)
+{
+    const R8int es = line->es, el = line->el;
+
+    // Interpolants at the first step
+    const R8interp zStep = (b->z - a->z) / el;
+    const R8interp uStep = (b->u - a->u) / el;
+    const R8interp vStep = (b->v - a->v) / el;
+
+    R8interp z = a->z + zStep * line->first;
+    R8interp u = a->u + uStep * line->first;
+    R8interp v = a->v + vStep * line->first;
+
+    R8int x   = line->x;
+    R8int y   = line->y;
+    R8int err = line->err;
+
+    #ifndef R8_TILED_FRAMEBUFFER
+    // Pixel offsets of the straight and diagonal steps
+    const R8int pitch = (R8int)frameBuffer->width;
+    const R8int pStep = line->pdx + line->pdy * pitch;
+    const R8int dStep = line->ddx + line->ddy * pitch;
+
+    R8int pixel = r8_framebuffer_index(frameBuffer, x, y);
+    #endif
+
+    // Render each pixel of the line
+    for (R8int t = 0; t < line->numPixels; ++t)
+    {
+        #ifdef R8_TILED_FRAMEBUFFER
+        const R8int pixel = r8_framebuffer_index(frameBuffer, x, y);
+        #endif
+
+        // Make depth test
+        R8DepthBuffer depth = r8_framebuffer_frame_depth(frameBuffer, r8_pixel_write_depth(z));
+        R8DepthBuffer oldDepth = r8_framebuffer_read_depth(frameBuffer, pixel);
+
+        if (depth > oldDepth)
+        {
+            if (hierarchicalZ)
+                r8_framebuffer_hiz_write(r8_framebuffer_hiz_tile(frameBuffer, (R8uint)x, (R8uint)y), oldDepth);
+
+            r8_framebuffer_write_depth(frameBuffer, pixel, depth);
+
+            if (texels != NULL)
+            {
+                #ifdef R8_PERSPECTIVE_CORRECTED
+                colorIndex = r8_texture_sample_nearest_from_mipmap(texels, mipWidth, mipHeight, (R8float)(u / z), (R8float)(v / z));
+                #else
+                colorIndex = r8_texture_sample_nearest_from_mipmap(texels, mipWidth, mipHeight, (R8float)u, (R8float)v);
+                #endif
+            }
+
+            R8_FRAMEBUFFER_COLOR(frameBuffer, pixel) = colorIndex;
+        }
+
+        // Increase interpolants
+        z += zStep;
+        u += uStep;
+        v += vStep;
+
+        // Move to next pixel
+        err -= es;
+        if (err < 0)
+        {
+            err += el;
+            x += line->ddx;
+            y += line->ddy;
+            #ifndef R8_TILED_FRAMEBUFFER
+            pixel += dStep;
+            #endif
+        }
+        else
+        {
+            x += line->pdx;
+            y += line->pdy;
+            #ifndef R8_TILED_FRAMEBUFFER
+            pixel += pStep;
+            #endif
         }
     }
 }
 
 // Rasterizes a textured line using the "Bresenham" algorithm
-static void _rasterize_line(R8FrameBuffer* frameBuffer, const R8Texture* texture, R8ubyte mipLevel, R8uint indexA, R8uint indexB)
+static void _rasterize_line(
+    R8FrameBuffer* frameBuffer, const R8RasterPolygon* polygon, R8int indexA, R8int indexB, const R8Rect* rect)
 {
-    const R8RasterVertex* vertexA = &(_rasterVertices[indexA]);
-    const R8RasterVertex* vertexB = &(_rasterVertices[indexB]);
+    const R8RasterVertex* vertexA = &(polygon->vertices[indexA]);
+    const R8RasterVertex* vertexB = &(polygon->vertices[indexB]);
 
-    // Select MIP level
-    R8texsize mipWidth = 0, mipHeight = 0;
-    const R8ColorBuffer* texels = r8_texture_select_miplevel(texture, mipLevel, &mipWidth, &mipHeight);
+    const R8ColorBuffer* texels = polygon->texels;
 
     // Pre-computations
     int dx = vertexB->x - vertexA->x;
@@ -331,15 +710,18 @@ static void _rasterize_line(R8FrameBuffer* frameBuffer, const R8Texture* texture
 
     int err = el/2;
 
-    R8ColorBuffer colorIndex;
+    R8ColorBuffer colorIndex = polygon->colorIndex;
 
     // Render each pixel of the line
     for (R8int t = 0; t < el; ++t)
     {
-        // Render pixel
-        colorIndex = r8_texture_sample_nearest_from_mipmap(texels, mipWidth, mipHeight, (R8float)u, (R8float)v);
-
-        r8_framebuffer_plot(frameBuffer, (R8uint)x, (R8uint)y, colorIndex);
+        // Render pixel (only inside the rectangle)
+        if (x >= rect->left && x <= rect->right && y >= rect->top && y <= rect->bottom)
+        {
+            if (texels != NULL)
+                colorIndex = r8_texture_sample_nearest_from_mipmap(texels, polygon->mipWidth, polygon->mipHeight, (R8float)u, (R8float)v);
+            r8_framebuffer_plot(frameBuffer, (R8uint)x, (R8uint)y, colorIndex);
+        }
 
         // Increase tex-coords
         u += uStep;
@@ -361,84 +743,227 @@ static void _rasterize_line(R8FrameBuffer* frameBuffer, const R8Texture* texture
     }
 }
 
-static void _render_indexed_lines_textured(
-    const R8Texture* texture, R8sizei numVertices, R8sizei firstVertex, const R8VertexBuffer* vertexBuffer, const R8IndexBuffer* indexBuffer)
+// Interpolates the clipping vertex 'c' at the parameter 't' of the line from 'a' to 'b'.
+static void _get_line_clip_vertex(R8ClipVertex* c, const R8ClipVertex* a, const R8ClipVertex* b, R8float t)
 {
-    //...
+    c->x = a->x + (b->x - a->x) * t;
+    c->y = a->y + (b->y - a->y) * t;
+    c->z = a->z + (b->z - a->z) * t;
+    c->w = a->w + (b->w - a->w) * t;
+    c->u = a->u + (b->u - a->u) * t;
+    c->v = a->v + (b->v - a->v) * t;
 }
 
-static void _render_indexed_lines_colored(
-    R8sizei numVertices, R8sizei firstVertex, const R8VertexBuffer* vertexBuffer, const R8IndexBuffer* indexBuffer)
+/*
+Clips the line from 'a' to 'b' in homogeneous clip space against the near and far planes and the guard band with the "Liang-Barsky" algorithm,
+and projects the clipped end points into screen space. Returns R8_FALSE if the line is entirely outside.
+The guard band keeps the screen coordinates inside the integer range; the clipping rectangle itself is applied in screen space (see '_setup_line').
+*/
+static R8boolean _clip_and_r8oject_line(R8ClipVertex* a, R8ClipVertex* b)
 {
-    //r8_framebuffer* frameBuffer = R8_STATE_MACHINE.boundFrameBuffer;
+    const R8float* guardBand = R8_STATE_MACHINE.guardBandBounds;
 
-    // Iterate over the index buffer
-    for (R8sizei i = firstVertex, n = numVertices + firstVertex; i + 1 < n; i += 2)
+    const R8float planes[6][4] =
     {
-        // Fetch indices
-        R8ushort indexA = indexBuffer->indices[i];
-        R8ushort indexB = indexBuffer->indices[i + 1];
+        {  0.0f,  0.0f,  1.0f,  0.0f         }, // Near plane
+        {  0.0f,  0.0f, -1.0f,  1.0f         }, // Far plane
+        {  1.0f,  0.0f,  0.0f, -guardBand[0] }, // Left
+        { -1.0f,  0.0f,  0.0f,  guardBand[1] }, // Right
+        {  0.0f,  1.0f,  0.0f, -guardBand[2] }, // Top
+        {  0.0f, -1.0f,  0.0f,  guardBand[3] }, // Bottom
+    };
 
-        #ifdef R8_DEBUG
-        if (indexA >= vertexBuffer->numVertices || indexB >= vertexBuffer->numVertices)
+    R8float t0 = 0.0f, t1 = 1.0f;
+
+    for (R8int i = 0; i < 6; ++i)
+    {
+        const R8float distA = _clipplane_distance(a, planes[i]);
+        const R8float distB = _clipplane_distance(b, planes[i]);
+
+        if (distA < 0.0f)
         {
-            R8_SET_ERROR_FATAL("element in index buffer out of bounds");
-            return;
+            if (distB < 0.0f)
+                return R8_FALSE;
+            t0 = R8_MAX(t0, distA / (distA - distB));
         }
-        #endif
+        else if (distB < 0.0f)
+            t1 = R8_MIN(t1, distA / (distA - distB));
+    }
+
+    if (t0 > t1)
+        return R8_FALSE;
 
-        // Fetch vertices
-        const R8Vertex* vertexA = (vertexBuffer->vertices + indexA);
-        const R8Vertex* vertexB = (vertexBuffer->vertices + indexB);
+    const R8ClipVertex start = *a, end = *b;
 
-        // Raster line
-        R8int x1 = (R8int)vertexA->ndc.x;
-        R8int y1 = (R8int)vertexA->ndc.y;
+    if (t0 > 0.0f)
+        _get_line_clip_vertex(a, &start, &end, t0);
+    if (t1 < 1.0f)
+        _get_line_clip_vertex(b, &start, &end, t1);
 
-        R8int x2 = (R8int)vertexB->ndc.x;
-        R8int y2 = (R8int)vertexB->ndc.y;
+    // Projection
+    _r8oject_vertex(a, &(R8_STATE_MACHINE.viewport));
+    _r8oject_vertex(b, &(R8_STATE_MACHINE.viewport));
+
+    return R8_TRUE;
+}
 
-        _render_screenspace_line_colored(x1, y1, x2, y2);
+// Derives the mip level of a textured line from its end points, the same way as for polygons (see '_compute_polygon_miplevel').
+static R8ubyte _compute_line_miplevel(const R8Texture* texture, R8interp zA, R8interp zB)
+{
+    if (R8_STATE_MACHINE.states[R8_MIP_MAPPING] != R8_FALSE && texture->mips > 0)
+    {
+        R8int zLog = r8_int_log2((R8float)(0.25f / R8_MIN(zA, zB)));
+        return R8_CLAMP(zLog, 0, texture->mips - 1);
     }
+    return 0;
 }
 
-void r8_render_screenspace_line(R8int x1, R8int y1, R8int x2, R8int y2)
+// Clips, projects, and rasterizes the 3D line between the transformed vertices. Lines are colored with the current color if 'texture' is null.
+static void _render_line(R8FrameBuffer* frameBuffer, const R8Texture* texture, R8ClipVertex a, R8ClipVertex b)
 {
-    // Get bound frame buffer
-    R8FrameBuffer* frameBuffer = R8_STATE_MACHINE.boundFrameBuffer;
+    if (!_clip_and_r8oject_line(&a, &b))
+        return;
 
-    if (frameBuffer == NULL)
-    {
-        R8_ERROR(R8_ERROR_INVALID_STATE);
+    // Clip line against the clipping rectangle in screen space
+    R8RasterVertex rasterA, rasterB;
+    R8RasterLine line;
+
+    _setup_raster_vertex(&rasterA, &a);
+    _setup_raster_vertex(&rasterB, &b);
+
+    if (!_setup_line(&line, rasterA.x, rasterA.y, rasterB.x, rasterB.y, &(R8_STATE_MACHINE.clipRect)))
         return;
-    }
 
-    #ifdef R8_ORIGIN_LEFT_TOP
-    y1 = frameBuffer->height - y1 - 1;
-    y2 = frameBuffer->height - y2 - 1;
-    #endif
+    _resolve_line(frameBuffer, &line);
 
-    _render_screenspace_line_colored(x1, y1, x2, y2);
-}
+    // Select texture mip level
+    const R8ColorBuffer* texels = NULL;
+    R8texsize mipWidth = 0, mipHeight = 0;
 
-void r8_render_lines(R8sizei numVertices, R8sizei firstVertex, const R8VertexBuffer* vertexBuffer)
-{
-    //...
-}
+    if (texture != NULL)
+        texels = r8_texture_select_miplevel(texture, _compute_line_miplevel(texture, rasterA.z, rasterB.z), &mipWidth, &mipHeight);
 
-void r8_render_line_strip(R8sizei numVertices, R8sizei firstVertex, const R8VertexBuffer* vertexBuffer)
-{
-    //...
+    _rasterize_line_depth(
+        frameBuffer, &line, &rasterA, &rasterB, texels, mipWidth, mipHeight,
+        R8_STATE_MACHINE.color0, R8_STATE_MACHINE.states[R8_HIERARCHICAL_Z]
+    );
 }
 
-void r8_render_line_loop(R8sizei numVertices, R8sizei firstVertex, const R8VertexBuffer* vertexBuffer)
+/*
+Renders the line segments of the vertices, which are fetched through the index buffer if 'indexBuffer' is not null.
+With primitive restart enabled, the restart index ends the current line strip or loop and starts a new one.
+*/
+static void _render_line_segments(
+    const R8Texture* texture, R8enum primitives, R8sizei numVertices, R8sizei firstVertex, const R8VertexBuffer* vertexBuffer, const R8IndexBuffer* indexBuffer)
 {
-    //...
-}
+    R8FrameBuffer* frameBuffer = R8_STATE_MACHINE.boundFrameBuffer;
 
-void r8_render_indexed_lines(R8sizei numVertices, R8sizei firstVertex, /*const */R8VertexBuffer* vertexBuffer, const R8IndexBuffer* indexBuffer)
-{
-    if (R8_STATE_MACHINE.boundFrameBuffer == NULL)
+    // Indexed vertex buffers which exceed the batch size are transformed per index
+    const R8boolean batched = (indexBuffer == NULL || vertexBuffer->numVertices <= R8_MAX_BATCH_VERTICES);
+
+    if (indexBuffer != NULL && batched)
+        _transform_vertices(vertexBuffer->numVertices, 0, vertexBuffer);
+
+    const R8boolean restart = (indexBuffer != NULL && primitives != R8_LINES && R8_STATE_MACHINE.states[R8_PRIMITIVE_RESTART]);
+    const R8uint restartIndex = (indexBuffer != NULL ? _primitive_restart_index(indexBuffer) : 0);
+
+    // First and previous vertex of the current strip, and number of vertices since the last restart
+    R8ClipVertex first, prev, vertex;
+    R8int k = 0;
+
+    for (R8sizei i = 0; i < numVertices; ++i)
+    {
+        // Fetch vertex
+        if (indexBuffer == NULL)
+        {
+            // Transform vertices in batches of bounded size
+            const R8sizei batchIndex = i % R8_MAX_BATCH_VERTICES;
+
+            if (batchIndex == 0)
+                _transform_vertices(R8_MIN(numVertices - i, R8_MAX_BATCH_VERTICES), firstVertex + i, vertexBuffer);
+
+            _fetch_vertex(&vertex, vertexBuffer, batchIndex, firstVertex + i);
+        }
+        else
+        {
+            const R8uint index = r8_indexbuffer_get(indexBuffer, firstVertex + i);
+
+            if (restart && index == restartIndex)
+            {
+                if (primitives == R8_LINE_LOOP && k > 2)
+                    _render_line(frameBuffer, texture, prev, first);
+                k = 0;
+                continue;
+            }
+
+            #ifdef R8_DEBUG
+            if (index >= (R8uint)vertexBuffer->numVertices)
+            {
+                R8_SET_ERROR_FATAL("element in index buffer out of bounds");
+                return;
+            }
+            #endif
+
+            if (batched)
+                _fetch_vertex(&vertex, vertexBuffer, index, index);
+            else
+                _transform_vertex(&vertex, vertexBuffer, index);
+        }
+
+        // Render segment from the previous vertex (only every second vertex ends a segment of separate lines)
+        if (k == 0)
+            first = vertex;
+        else if (primitives != R8_LINES || (k % 2) == 1)
+            _render_line(frameBuffer, texture, prev, vertex);
+
+        prev = vertex;
+        ++k;
+    }
+
+    // Close line loop
+    if (primitives == R8_LINE_LOOP && k > 2)
+        _render_line(frameBuffer, texture, prev, first);
+}
+
+// Returns the bound texture, or null if lines are colored with the current color.
+static const R8Texture* _get_line_texture()
+{
+    const R8Texture* texture = R8_STATE_MACHINE.boundTexture;
+    return (texture != NULL && texture->texels != NULL ? texture : NULL);
+}
+
+static void _render_line_primitives(R8enum primitives, R8sizei numVertices, R8sizei firstVertex, const R8VertexBuffer* vertexBuffer)
+{
+    r8_tile_binner_flush();
+
+    if (R8_STATE_MACHINE.boundFrameBuffer == NULL)
+    {
+        R8_ERROR(R8_ERROR_INVALID_STATE);
+        return;
+    }
+    if (vertexBuffer == NULL)
+    {
+        R8_ERROR(R8_ERROR_NULL_POINTER);
+        return;
+    }
+    if (!_is_valid_range(firstVertex, numVertices, vertexBuffer->numVertices))
+    {
+        R8_ERROR(R8_ERROR_INVALID_ARGUMENT);
+        return;
+    }
+
+    if (numVertices < 2 || _is_draw_culled(vertexBuffer))
+        return;
+
+    _render_line_segments(_get_line_texture(), primitives, numVertices, firstVertex, vertexBuffer, NULL);
+}
+
+static void _render_indexed_line_primitives(
+    R8enum primitives, R8sizei numVertices, R8sizei firstVertex, const R8VertexBuffer* vertexBuffer, const R8IndexBuffer* indexBuffer)
+{
+    r8_tile_binner_flush();
+
+    if (R8_STATE_MACHINE.boundFrameBuffer == NULL)
     {
         R8_ERROR(R8_ERROR_INVALID_STATE);
         return;
@@ -448,28 +973,86 @@ void r8_render_indexed_lines(R8sizei numVertices, R8sizei firstVertex, /*const *
         R8_ERROR(R8_ERROR_NULL_POINTER);
         return;
     }
-    if (firstVertex + numVertices > indexBuffer->numIndices)
+    if (!_is_valid_range(firstVertex, numVertices, indexBuffer->numIndices))
     {
         R8_ERROR(R8_ERROR_INVALID_ARGUMENT);
         return;
     }
 
-    _vertexbuffer_transform_all(vertexBuffer);
+    if (numVertices < 2 || _is_draw_culled(vertexBuffer))
+        return;
 
-    if (R8_STATE_MACHINE.boundTexture != NULL)
-        _render_indexed_lines_textured(R8_STATE_MACHINE.boundTexture, numVertices, firstVertex, vertexBuffer, indexBuffer);
-    else
-        _render_indexed_lines_colored(numVertices, firstVertex, vertexBuffer, indexBuffer);
+    _render_line_segments(_get_line_texture(), primitives, numVertices, firstVertex, vertexBuffer, indexBuffer);
+}
+
+void r8_render_screenspace_line(R8int x1, R8int y1, R8int x2, R8int y2)
+{
+    r8_tile_binner_flush();
+
+    // Get bound frame buffer
+    R8FrameBuffer* frameBuffer = R8_STATE_MACHINE.boundFrameBuffer;
+
+    if (frameBuffer == NULL)
+    {
+        R8_ERROR(R8_ERROR_INVALID_STATE);
+        return;
+    }
+
+    #ifdef R8_ORIGIN_LEFT_TOP
+    y1 = frameBuffer->height - y1 - 1;
+    y2 = frameBuffer->height - y2 - 1;
+    #endif
+
+    /*
+    Clip line against the frame buffer enlarged by the guard band first, so that the line setup doesn't overflow,
+    and then exactly against the frame buffer
+    */
+    const R8Rect guardBand =
+    {
+        -R8_GUARD_BAND_SIZE,
+        -R8_GUARD_BAND_SIZE,
+        (R8int)frameBuffer->width + R8_GUARD_BAND_SIZE,
+        (R8int)frameBuffer->height + R8_GUARD_BAND_SIZE
+    };
+    const R8Rect rect = { 0, 0, (R8int)frameBuffer->width - 1, (R8int)frameBuffer->height - 1 };
+
+    R8RasterLine line;
+
+    if (!_clip_screenspace_line(&x1, &y1, &x2, &y2, &guardBand) || !_setup_line(&line, x1, y1, x2, y2, &rect))
+        return;
+
+    _resolve_line(frameBuffer, &line);
+    _rasterize_line_colored(frameBuffer, &line, R8_STATE_MACHINE.color0);
+}
+
+void r8_render_lines(R8sizei numVertices, R8sizei firstVertex, const R8VertexBuffer* vertexBuffer)
+{
+    _render_line_primitives(R8_LINES, numVertices, firstVertex, vertexBuffer);
+}
+
+void r8_render_line_strip(R8sizei numVertices, R8sizei firstVertex, const R8VertexBuffer* vertexBuffer)
+{
+    _render_line_primitives(R8_LINE_STRIP, numVertices, firstVertex, vertexBuffer);
+}
+
+void r8_render_line_loop(R8sizei numVertices, R8sizei firstVertex, const R8VertexBuffer* vertexBuffer)
+{
+    _render_line_primitives(R8_LINE_LOOP, numVertices, firstVertex, vertexBuffer);
+}
+
+void r8_render_indexed_lines(R8sizei numVertices, R8sizei firstVertex, const R8VertexBuffer* vertexBuffer, const R8IndexBuffer* indexBuffer)
+{
+    _render_indexed_line_primitives(R8_LINES, numVertices, firstVertex, vertexBuffer, indexBuffer);
 }
 
 void r8_render_indexed_line_strip(R8sizei numVertices, R8sizei firstVertex, const R8VertexBuffer* vertexBuffer, const R8IndexBuffer* indexBuffer)
 {
-    //...
+    _render_indexed_line_primitives(R8_LINE_STRIP, numVertices, firstVertex, vertexBuffer, indexBuffer);
 }
 
 void r8_render_indexed_line_loop(R8sizei numVertices, R8sizei firstVertex, const R8VertexBuffer* vertexBuffer, const R8IndexBuffer* indexBuffer)
 {
-    //...
+    _render_indexed_line_primitives(R8_LINE_LOOP, numVertices, firstVertex, vertexBuffer, indexBuffer);
 }
 
 // --- images --- //
@@ -495,16 +1078,14 @@ static void _render_screenspace_image_textured(const R8Texture* texture, R8int l
     if (left > right)
         R8_SWAP(R8int, left, right);
 
+    _resolve_rect(frameBuffer, left, top, right, bottom);
+
     // Select MIP level
     R8texsize width = 0, height = 0;
     R8ubyte mipLevel = 0;//_r8_texture_compute_miplevel(texture, 1.0f / (R8float)(right - left), 0.0f, 0.0f, 1.0f / (R8float)(bottom - top));
     const R8ColorBuffer* texels = r8_texture_select_miplevel(texture, mipLevel, &width, &height);
 
     // Rasterize rectangle
-    R8Pixel* pixels = frameBuffer->pixels;
-    const R8uint pitch = frameBuffer->width;
-    R8Pixel* scanline;
-
     R8float u = 0.0f;
     #ifdef R8_ORIGIN_LEFT_TOP
     R8float v = 1.0f;
@@ -515,15 +1096,24 @@ static void _render_screenspace_image_textured(const R8Texture* texture, R8int l
     const R8float uStep = 1.0f / ((R8float)(right - left));
     const R8float vStep = 1.0f / ((R8float)(bottom - top));
 
+    // Step along the rows in 16.16 fixed point for power-of-two textures
+    const R8boolean pow2 = (texture->pow2 && width > 0 && height > 0);
+    const R8ubyte widthShift = (pow2 ? r8_texture_size_shift(width) : 0);
+    const R8uint uFixedStep = (pow2 ? r8_texture_fixed_step(uStep, width) : 0);
+    R8uint uFixed, vFixed;
+
     for (R8int y = top; y <= bottom; ++y)
     {
-        scanline = pixels + (y * pitch + left);
-
         u = 0.0f;
+        uFixed = 0;
+        vFixed = (pow2 ? r8_texture_fixed_coord(v, height) : 0);
 
         for (R8int x = left; x <= right; ++x)
         {
-            R8ColorBuffer color = r8_texture_sample_nearest_from_mipmap(texels, width, height, u, v);
+            R8ColorBuffer color = (pow2 ?
+                r8_texture_sample_nearest_pow2(texels, widthShift, (R8uint)width - 1, (R8uint)height - 1, uFixed, vFixed) :
+                r8_texture_sample_nearest_from_mipmap(texels, width, height, u, v)
+            );
 
             #ifdef R8_BLACK_IS_ALPHA
             #   ifdef R8_COLOR_BUFFER_24BIT
@@ -535,14 +1125,14 @@ static void _render_screenspace_image_textured(const R8Texture* texture, R8int l
             #   endif
             #endif
 
-            scanline->colorIndex = color;
+            R8_FRAMEBUFFER_COLOR(frameBuffer, r8_framebuffer_index(frameBuffer, x, y)) = color;
 
             #ifdef R8_BLACK_IS_ALPHA
             }
             #endif
 
-            ++scanline;
             u += uStep;
+            uFixed += uFixedStep;
         }
 
         #ifdef R8_ORIGIN_LEFT_TOP
@@ -574,24 +1164,20 @@ static void _render_screenspace_image_colored(R8ColorBuffer colorIndex, R8int le
     if (left > right)
         R8_SWAP(R8int, left, right);
 
-    // Rasterize rectangle
-    R8Pixel* pixels = frameBuffer->pixels;
-    const R8uint pitch = frameBuffer->width;
-    R8Pixel* scanline;
+    _resolve_rect(frameBuffer, left, top, right, bottom);
 
+    // Rasterize rectangle
     for (R8int y = top; y <= bottom; ++y)
     {
-        scanline = pixels + (y * pitch + left);
         for (R8int x = left; x <= right; ++x)
-        {
-            scanline->colorIndex = colorIndex;
-            ++scanline;
-        }
+            R8_FRAMEBUFFER_COLOR(frameBuffer, r8_framebuffer_index(frameBuffer, x, y)) = colorIndex;
     }
 }
 
 void r8_render_screenspace_image(R8int left, R8int top, R8int right, R8int bottom)
 {
+    r8_tile_binner_flush();
+
     if (R8_STATE_MACHINE.boundFrameBuffer != NULL)
     {
         if (R8_STATE_MACHINE.boundTexture != NULL)
@@ -605,79 +1191,120 @@ void r8_render_screenspace_image(R8int left, R8int top, R8int right, R8int botto
 
 // --- triangles --- //
 
-// Computes the vertex 'c' which is cliped between the vertices 'a' and 'b' and the plane 'z'
-static R8ClipVertex _get_zplane_vertex(R8ClipVertex a, R8ClipVertex b, R8float z)
+// Outcode bits of a vertex in clip space
+#define OUTCODE_LEFT    0x01
+#define OUTCODE_RIGHT   0x02
+#define OUTCODE_TOP     0x04
+#define OUTCODE_BOTTOM  0x08
+#define OUTCODE_NEAR    0x10
+#define OUTCODE_FAR     0x20
+#define OUTCODE_GUARD   0x40
+
+#define OUTCODE_Z       (OUTCODE_NEAR | OUTCODE_FAR)
+
+/*
+Returns the outcode of the vertex against the view volume in homogeneous clip space, i.e. before the perspective division.
+The x and y planes enclose the clipping rectangle (see 'clipBounds' in the state machine)
+and the z planes are 0 <= z <= w, which are the near and far planes of the projection matrix.
+OUTCODE_GUARD is set if the vertex lies outside of the guard band (see 'guardBandBounds' in the state machine).
+*/
+static R8uint _compute_outcode(const R8ClipVertex* vertex, const R8float* bounds, const R8float* guardBand)
+{
+    R8uint outcode = 0;
+
+    if (vertex->x < guardBand[0] * vertex->w || vertex->x > guardBand[1] * vertex->w ||
+        vertex->y < guardBand[2] * vertex->w || vertex->y > guardBand[3] * vertex->w)
+    {
+        outcode |= OUTCODE_GUARD;
+    }
+
+    if (vertex->x < bounds[0] * vertex->w)
+        outcode |= OUTCODE_LEFT;
+    if (vertex->x > bounds[1] * vertex->w)
+        outcode |= OUTCODE_RIGHT;
+    if (vertex->y < bounds[2] * vertex->w)
+        outcode |= OUTCODE_TOP;
+    if (vertex->y > bounds[3] * vertex->w)
+        outcode |= OUTCODE_BOTTOM;
+    if (vertex->z < 0.0f)
+        outcode |= OUTCODE_NEAR;
+    if (vertex->z > vertex->w)
+        outcode |= OUTCODE_FAR;
+
+    return outcode;
+}
+
+// Computes the vertex 'c' which is cliped between the vertices 'a' and 'b' with the plane distances 'distA' and 'distB'
+static R8ClipVertex _get_clipplane_vertex(const R8ClipVertex* a, const R8ClipVertex* b, R8float distA, R8float distB)
 {
-    R8interp m = ((R8interp)(z - b.z)) / (a.z - b.z);
+    R8interp m = ((R8interp)distB) / (distB - distA);
     R8ClipVertex c;
 
-    c.x = (R8float)(m * (a.x - b.x) + b.x);
-    c.y = (R8float)(m * (a.y - b.y) + b.y);
-    c.z = z;
-    c.w = (R8float)(m * (a.w - b.w) + b.w);
+    c.x = (R8float)(m * (a->x - b->x) + b->x);
+    c.y = (R8float)(m * (a->y - b->y) + b->y);
+    c.z = (R8float)(m * (a->z - b->z) + b->z);
+    c.w = (R8float)(m * (a->w - b->w) + b->w);
 
-    c.u = (R8float)(m * (a.u - b.u) + b.u);
-    c.v = (R8float)(m * (a.v - b.v) + b.v);
+    c.u = (R8float)(m * (a->u - b->u) + b->u);
+    c.v = (R8float)(m * (a->v - b->v) + b->v);
 
     return c;
 }
 
-// Clips the polygon at the z planes
-static void _polygon_z_clipping(R8float zMin, R8float zMax)
+// Clips the polygon 'src' at the homogeneous plane and stores the result in 'dst'. Returns the new number of vertices.
+static R8int _polygon_plane_clipping(R8ClipVertex* dst, const R8ClipVertex* src, R8int numVerts, const R8float* plane)
 {
-    R8int x, y;
+    R8int x, y, localNumVerts = 0;
 
-    // Clip at near clipping plane (zMin)
-    R8int localNumVerts = 0;
+    R8float distX = _clipplane_distance(&(src[numVerts - 1]), plane), distY;
 
-    for (x = _numPolyVerts - 1, y = 0; y < _numPolyVerts; x = y, ++y)
+    for (x = numVerts - 1, y = 0; y < numVerts; x = y, ++y, distX = distY)
     {
+        distY = _clipplane_distance(&(src[y]), plane);
+
         // Inside
-        if (_clipVertices[x].z >= zMin && _clipVertices[y].z >= zMin)
-            _clipVerticesTmp[localNumVerts++] = _clipVertices[y];
+        if (distX >= 0.0f && distY >= 0.0f)
+            dst[localNumVerts++] = src[y];
 
         // Leaving
-        if (_clipVertices[x].z >= zMin && _clipVertices[y].z < zMin)
-            _clipVerticesTmp[localNumVerts++] = _get_zplane_vertex(_clipVertices[x], _clipVertices[y], zMin);
+        if (distX >= 0.0f && distY < 0.0f)
+            dst[localNumVerts++] = _get_clipplane_vertex(&(src[x]), &(src[y]), distX, distY);
 
         // Entering
-        if (_clipVertices[x].z < zMin && _clipVertices[y].z >= zMin)
+        if (distX < 0.0f && distY >= 0.0f)
         {
-            _clipVerticesTmp[localNumVerts++] = _get_zplane_vertex(_clipVertices[x], _clipVertices[y], zMin);
-            _clipVerticesTmp[localNumVerts++] = _clipVertices[y];
+            dst[localNumVerts++] = _get_clipplane_vertex(&(src[x]), &(src[y]), distX, distY);
+            dst[localNumVerts++] = src[y];
         }
     }
 
-    // Clip at far clipping plane (zMax)
-    _numPolyVerts = 0;
+    return localNumVerts;
+}
 
-    for (x = localNumVerts - 1, y = 0; y < localNumVerts; x = y, ++y)
-    {
-        // Inside
-        if (_clipVerticesTmp[x].z <= zMax && _clipVerticesTmp[y].z <= zMax)
-            _clipVertices[_numPolyVerts++] = _clipVerticesTmp[y];
+// Clips the polygon at the near (z >= 0) and far (z <= w) planes in homogeneous clip space
+static void _polygon_z_clipping()
+{
+    static const R8float nearPlane[4] = { 0.0f, 0.0f, 1.0f, 0.0f };
+    static const R8float farPlane[4] = { 0.0f, 0.0f, -1.0f, 1.0f };
 
-        // Leaving
-        if (_clipVerticesTmp[x].z <= zMax && _clipVerticesTmp[y].z > zMax)
-            _clipVertices[_numPolyVerts++] = _get_zplane_vertex(_clipVerticesTmp[x], _clipVerticesTmp[y], zMax);
+    R8int localNumVerts = _polygon_plane_clipping(_clipVerticesTmp, _clipVertices, _numPolyVerts, nearPlane);
 
-        // Entering
-        if (_clipVerticesTmp[x].z > zMax && _clipVerticesTmp[y].z <= zMax)
-        {
-            _clipVertices[_numPolyVerts++] = _get_zplane_vertex(_clipVerticesTmp[x], _clipVerticesTmp[y], zMax);
-            _clipVertices[_numPolyVerts++] = _clipVerticesTmp[y];
-        }
-    }
+    if (localNumVerts < 3)
+        _numPolyVerts = 0;
+    else
+        _numPolyVerts = _polygon_plane_clipping(_clipVertices, _clipVerticesTmp, localNumVerts, farPlane);
 }
 
-// Computes the vertex 'c' which is cliped between the vertices 'a' and 'b' and the plane 'x'
-static R8RasterVertex _get_xplane_vertex(R8RasterVertex a, R8RasterVertex b, R8int x)
+// Computes the vertex 'c' which is cliped between the vertices 'a' and 'b' and the plane 'x' (or 'subX' in sub-pixel coordinates)
+static R8RasterVertex _get_xplane_vertex(R8RasterVertex a, R8RasterVertex b, R8int x, R8int subX)
 {
     R8interp m = ((R8interp)(x - b.x)) / (a.x - b.x);
     R8RasterVertex c;
 
     c.x = x;
     c.y = (R8int)(m * (a.y - b.y) + b.y);
+    c.subX = subX;
+    c.subY = (R8int)(m * (a.subY - b.subY) + b.subY);
     c.z = m * (a.z - b.z) + b.z;
 
     c.u = m * (a.u - b.u) + b.u;
@@ -686,14 +1313,16 @@ static R8RasterVertex _get_xplane_vertex(R8RasterVertex a, R8RasterVertex b, R8i
     return c;
 }
 
-// Computes the vertex 'c' which is cliped between the vertices 'a' and 'b' and the plane 'y'
-static R8RasterVertex _get_yplane_vertex(R8RasterVertex a, R8RasterVertex b, R8int y)
+// Computes the vertex 'c' which is cliped between the vertices 'a' and 'b' and the plane 'y' (or 'subY' in sub-pixel coordinates)
+static R8RasterVertex _get_yplane_vertex(R8RasterVertex a, R8RasterVertex b, R8int y, R8int subY)
 {
     R8interp m = ((R8interp)(y - b.y)) / (a.y - b.y);
     R8RasterVertex c;
 
     c.x = (R8int)(m * (a.x - b.x) + b.x);
     c.y = y;
+    c.subX = (R8int)(m * (a.subX - b.subX) + b.subX);
+    c.subY = subY;
     c.z = m * (a.z - b.z) + b.z;
 
     c.u = m * (a.u - b.u) + b.u;
@@ -707,6 +1336,12 @@ static void _polygon_xy_clipping(R8int xMin, R8int xMax, R8int yMin, R8int yMax)
 {
     R8int x, y;
 
+    // Sub-pixel clipping planes enclose the entire border pixels
+    const R8int subMinX = xMin << R8_SUBPIXEL_BITS;
+    const R8int subMaxX = (xMax + 1) << R8_SUBPIXEL_BITS;
+    const R8int subMinY = yMin << R8_SUBPIXEL_BITS;
+    const R8int subMaxY = (yMax + 1) << R8_SUBPIXEL_BITS;
+
     // Clip at left clipping plane (xMin)
     R8int localNumVerts = 0;
 
@@ -718,12 +1353,12 @@ static void _polygon_xy_clipping(R8int xMin, R8int xMax, R8int yMin, R8int yMax)
 
         // Leaving
         if (_rasterVertices[x].x >= xMin && _rasterVertices[y].x < xMin)
-            _rasterVerticesTmp[localNumVerts++] = _get_xplane_vertex(_rasterVertices[x], _rasterVertices[y], xMin);
+            _rasterVerticesTmp[localNumVerts++] = _get_xplane_vertex(_rasterVertices[x], _rasterVertices[y], xMin, subMinX);
 
         // Entering
         if (_rasterVertices[x].x < xMin && _rasterVertices[y].x >= xMin)
         {
-            _rasterVerticesTmp[localNumVerts++] = _get_xplane_vertex(_rasterVertices[x], _rasterVertices[y], xMin);
+            _rasterVerticesTmp[localNumVerts++] = _get_xplane_vertex(_rasterVertices[x], _rasterVertices[y], xMin, subMinX);
             _rasterVerticesTmp[localNumVerts++] = _rasterVertices[y];
         }
     }
@@ -739,12 +1374,12 @@ static void _polygon_xy_clipping(R8int xMin, R8int xMax, R8int yMin, R8int yMax)
 
         // Leaving
         if (_rasterVerticesTmp[x].x <= xMax && _rasterVerticesTmp[y].x > xMax)
-            _rasterVertices[_numPolyVerts++] = _get_xplane_vertex(_rasterVerticesTmp[x], _rasterVerticesTmp[y], xMax);
+            _rasterVertices[_numPolyVerts++] = _get_xplane_vertex(_rasterVerticesTmp[x], _rasterVerticesTmp[y], xMax, subMaxX);
 
         // Entering
         if (_rasterVerticesTmp[x].x > xMax && _rasterVerticesTmp[y].x <= xMax)
         {
-            _rasterVertices[_numPolyVerts++] = _get_xplane_vertex(_rasterVerticesTmp[x], _rasterVerticesTmp[y], xMax);
+            _rasterVertices[_numPolyVerts++] = _get_xplane_vertex(_rasterVerticesTmp[x], _rasterVerticesTmp[y], xMax, subMaxX);
             _rasterVertices[_numPolyVerts++] = _rasterVerticesTmp[y];
         }
     }
@@ -760,12 +1395,12 @@ static void _polygon_xy_clipping(R8int xMin, R8int xMax, R8int yMin, R8int yMax)
 
         // Leaving
         if (_rasterVertices[x].y >= yMin && _rasterVertices[y].y < yMin)
-            _rasterVerticesTmp[localNumVerts++] = _get_yplane_vertex(_rasterVertices[x], _rasterVertices[y], yMin);
+            _rasterVerticesTmp[localNumVerts++] = _get_yplane_vertex(_rasterVertices[x], _rasterVertices[y], yMin, subMinY);
 
         // Entering
         if (_rasterVertices[x].y < yMin && _rasterVertices[y].y >= yMin)
         {
-            _rasterVerticesTmp[localNumVerts++] = _get_yplane_vertex(_rasterVertices[x], _rasterVertices[y], yMin);
+            _rasterVerticesTmp[localNumVerts++] = _get_yplane_vertex(_rasterVertices[x], _rasterVertices[y], yMin, subMinY);
             _rasterVerticesTmp[localNumVerts++] = _rasterVertices[y];
         }
     }
@@ -781,12 +1416,12 @@ static void _polygon_xy_clipping(R8int xMin, R8int xMax, R8int yMin, R8int yMax)
 
         // Leaving
         if (_rasterVerticesTmp[x].y <= yMax && _rasterVerticesTmp[y].y > yMax)
-            _rasterVertices[_numPolyVerts++] = _get_yplane_vertex(_rasterVerticesTmp[x], _rasterVerticesTmp[y], yMax);
+            _rasterVertices[_numPolyVerts++] = _get_yplane_vertex(_rasterVerticesTmp[x], _rasterVerticesTmp[y], yMax, subMaxY);
 
         // Entering
         if (_rasterVerticesTmp[x].y > yMax && _rasterVerticesTmp[y].y <= yMax)
         {
-            _rasterVertices[_numPolyVerts++] = _get_yplane_vertex(_rasterVerticesTmp[x], _rasterVerticesTmp[y], yMax);
+            _rasterVertices[_numPolyVerts++] = _get_yplane_vertex(_rasterVerticesTmp[x], _rasterVerticesTmp[y], yMax, subMaxY);
             _rasterVertices[_numPolyVerts++] = _rasterVerticesTmp[y];
         }
     }
@@ -807,50 +1442,105 @@ static void _index_dec(R8int* x, R8int numVertices)
 }
 
 // Rasterizes convex polygon filled
-static void _rasterize_polygon_fill(R8FrameBuffer* frameBuffer, const R8Texture* texture, R8ubyte mipLevel)
+#ifdef R8_PERSPECTIVE_CORRECTED
+
+// Computes the perspective corrected texture coordinates at the specified pixel of a scanline.
+R8_INLINE void _perspective_texcoord(
+    const R8ScalineSide* side, R8interp zStep, R8interp uStep, R8interp vStep, R8int pixel, R8interp* u, R8interp* v)
 {
-    // Select MIP level
-    R8texsize mipWidth = 0, mipHeight = 0;
-    const R8ColorBuffer* texels = r8_texture_select_miplevel(texture, mipLevel, &mipWidth, &mipHeight);
+    const R8interp z = R8_FLOAT(1.0) / (side->z + zStep * pixel);
+    *u = (side->u + uStep * pixel) * z;
+    *v = (side->v + vStep * pixel) * z;
+}
+
+#endif
+
+static void _rasterize_polygon_fill(
+    R8FrameBuffer* frameBuffer, const R8RasterPolygon* polygon, R8ScalineSide* scanlinesStart, R8ScalineSide* scanlinesEnd, const R8Rect* rect)
+{
+    const R8RasterVertex* vertices = polygon->vertices;
+    const R8int numVertices = polygon->numVertices;
 
     // Find left- and right sided polygon edges
     R8int x, y, top = 0, bottom = 0;
 
-    for (x = 1; x < _numPolyVerts; ++x)
+    for (x = 1; x < numVertices; ++x)
     {
-        if (_rasterVertices[top].y > _rasterVertices[x].y)
+        if (vertices[top].y > vertices[x].y)
             top = x;
-        if (_rasterVertices[bottom].y < _rasterVertices[x].y)
+        if (vertices[bottom].y < vertices[x].y)
             bottom = x;
     }
 
     // Setup raster scanline sides
-    R8ScalineSide* leftSide = frameBuffer->scanlinesStart;
-    R8ScalineSide* rightSide = frameBuffer->scanlinesEnd;
+    R8ScalineSide* leftSide = scanlinesStart;
+    R8ScalineSide* rightSide = scanlinesEnd;
+
+    if (vertices[top].y == vertices[bottom].y)
+    {
+        // Polygon covers a single row only, so the edge walk below would not set up any scanline
+        R8int left = 0, right = 0;
+
+        for (x = 1; x < numVertices; ++x)
+        {
+            if (vertices[left].x > vertices[x].x)
+                left = x;
+            if (vertices[right].x < vertices[x].x)
+                right = x;
+        }
+
+        r8_framebuffer_setup_scanlines(frameBuffer, leftSide, vertices[left], vertices[left]);
+        r8_framebuffer_setup_scanlines(frameBuffer, rightSide, vertices[right], vertices[right]);
+    }
+    else
+    {
+        x = y = top;
+        for (_index_dec(&y, numVertices); x != bottom; x = y, _index_dec(&y, numVertices))
+            r8_framebuffer_setup_scanlines(frameBuffer, leftSide, vertices[x], vertices[y]);
+
+        x = y = top;
+        for (_index_inc(&y, numVertices); x != bottom; x = y, _index_inc(&y, numVertices))
+            r8_framebuffer_setup_scanlines(frameBuffer, rightSide, vertices[x], vertices[y]);
+    }
+
+    // Only the rows inside the rectangle are rasterized (the scanline sides are only setup inside the frame buffer)
+    R8int yStart = R8_MAX(vertices[top].y, rect->top);
+    R8int yEnd = R8_MIN(vertices[bottom].y, rect->bottom);
 
-    x = y = top;
-    for (_index_dec(&y, _numPolyVerts); x != bottom; x = y, _index_dec(&y, _numPolyVerts))
-        r8_framebuffer_setup_scanlines(frameBuffer, leftSide, _rasterVertices[x], _rasterVertices[y]);
+    if (yStart > yEnd)
+        return;
 
-    x = y = top;
-    for (_index_inc(&y, _numPolyVerts); x != bottom; x = y, _index_inc(&y, _numPolyVerts))
-        r8_framebuffer_setup_scanlines(frameBuffer, rightSide, _rasterVertices[x], _rasterVertices[y]);
+    /*
+    Check if sides must be swaped. The middle row is clamped to the rows of the polygon inside its clipping rectangle (not the tile rectangle),
+    so all tiles of the polygon select the same sides.
+    */
+    long midIndex = (vertices[bottom].y + vertices[top].y) / 2;
+    midIndex = R8_CLAMP(midIndex, R8_MAX(vertices[top].y, polygon->clipRect.top), R8_MIN(vertices[bottom].y, polygon->clipRect.bottom));
 
-    // Check if sides must be swaped
-    long midIndex = (_rasterVertices[bottom].y + _rasterVertices[top].y) / 2;
-    if (frameBuffer->scanlinesStart[midIndex].offset > frameBuffer->scanlinesEnd[midIndex].offset)
+    if (scanlinesStart[midIndex].offset > scanlinesEnd[midIndex].offset)
         R8_SWAP(R8ScalineSide*, leftSide, rightSide);
 
     // Start rasterizing the polygon
-    R8int len, offset;
+    R8int len, offset, rowX, first, last;
     R8interp z, zAct, zStep;
-    R8interp u, uAct, uStep;
-    R8interp v, vAct, vStep;
+    R8interp u, uStep;
+    R8interp v, vStep;
+
+    #ifdef R8_PERSPECTIVE_CORRECTED
+    R8int spanSize = 0, spanStart = -1, spanEnd = -1;
+    R8interp uSpan = R8_FLOAT(0.0), uSpanStep = R8_FLOAT(0.0), uNext = R8_FLOAT(0.0);
+    R8interp vSpan = R8_FLOAT(0.0), vSpanStep = R8_FLOAT(0.0), vNext = R8_FLOAT(0.0);
+    R8uint uFixed = 0, uFixedStep = 0;
+    R8uint vFixed = 0, vFixedStep = 0;
+
+    const R8uint mipWidthMask = (R8uint)polygon->mipWidth - 1;
+    const R8uint mipHeightMask = (R8uint)polygon->mipHeight - 1;
+    #endif
 
-    R8int yStart = _rasterVertices[top].y;
-    R8int yEnd = _rasterVertices[bottom].y;
+    const R8int pitch = (R8int)frameBuffer->width;
+    const R8ColorBuffer* texels = polygon->texels;
 
-    R8Pixel* pixel;
+    R8int rejectedSpans = 0, rejectedPixels = 0;
 
     // Rasterize each scanline
     for (y = yStart; y <= yEnd; ++y)
@@ -863,106 +1553,321 @@ static void _rasterize_polygon_fill(R8FrameBuffer* frameBuffer, const R8Texture*
         uStep = (rightSide[y].u - leftSide[y].u) / len;
         vStep = (rightSide[y].v - leftSide[y].v) / len;
 
+        #ifdef R8_PERSPECTIVE_CORRECTED
+        /*
+        Texture coordinates are only perspective corrected at the ends of each span and interpolated linearly in between.
+        If the depth interpolant hardly changes, the entire scanline is a single span.
+        */
+        zAct = rightSide[y].z - leftSide[y].z;
+        if (zAct < R8_FLOAT(0.0))
+            zAct = -zAct;
+
+        spanSize = (zAct <= R8_PERSPECTIVE_TOLERANCE * R8_MIN(leftSide[y].z, rightSide[y].z) ? len : R8_PERSPECTIVE_SPAN_SIZE);
+        spanStart = spanEnd = -1;
+        #endif
+
+        /*
+        Clamp scanline to rectangle. Interpolants are computed from the scanline start for each pixel,
+        so a scanline which is split between several tiles is rasterized exactly the same way.
+        */
         offset = leftSide[y].offset;
-        zAct = leftSide[y].z;
-        uAct = leftSide[y].u;
-        vAct = leftSide[y].v;
+        rowX = offset - y * pitch;
+        first = R8_MAX(0, rect->left - rowX);
+        last = R8_MIN(len, rect->right - rowX);
 
-        // Rasterize current scanline
-        while (len-- >= 0)
+        // Rasterize current scanline in segments which don't cross Hi-Z tile boundaries
+        for (R8int i = first, segmentEnd; i <= last; i = segmentEnd + 1)
         {
-            // Fetch pixel from framebuffer
-            pixel = &(frameBuffer->pixels[offset]);
+            R8HiZTile* tile = NULL;
+            segmentEnd = last;
 
-            // Make depth test
-            R8DepthBuffer depth = r8_pixel_write_depth(zAct);
-
-            if (depth > pixel->depth)
+            if (polygon->hierarchicalZ)
             {
-                pixel->depth = depth;
+                const R8int segmentX = rowX + i;
+                segmentEnd = R8_MIN(last, i + (R8_HIZ_TILE_SIZE - 1) - (segmentX & (R8_HIZ_TILE_SIZE - 1)));
 
-                #ifdef R8_PERSPECTIVE_CORRECTED
-                // Compute perspective corrected texture coordinates
-                z = R8_FLOAT(1.0) / zAct;
-                u = uAct * z;
-                v = vAct * z;
-                #else
-                z = zAct;
-                u = uAct;
-                v = vAct;
-                #endif
+                // Skip segment if even its nearest pixel is behind the farthest pixel of the tile
+                R8interp zMax = R8_MAX(leftSide[y].z + zStep * i, leftSide[y].z + zStep * segmentEnd);
 
-                // Sample texture
-                pixel->colorIndex = r8_texture_sample_nearest_from_mipmap(texels, mipWidth, mipHeight, (R8float)u, (R8float)v);
-                //pixel->colorIndex = _r8_texture_sample_nearest(texture, u, v, uStep*z, vStep*z);
-                //pixel->colorIndex = (R8ubyte)(zAct * (R8float)UCHAR_MAX);
+                if (r8_framebuffer_hiz_occluded(frameBuffer, segmentX, y, r8_framebuffer_frame_depth(frameBuffer, r8_pixel_write_depth(zMax))))
+                {
+                    ++rejectedSpans;
+                    rejectedPixels += segmentEnd - i + 1;
+                    continue;
+                }
+
+                tile = r8_framebuffer_hiz_tile(frameBuffer, segmentX, y);
             }
 
-            // Next pixel
-            ++offset;
-            zAct += zStep;
-            uAct += uStep;
-            vAct += vStep;
+            for (R8int j = i; j <= segmentEnd; ++j)
+            {
+                // Fetch pixel from framebuffer
+                const R8int pixel = r8_framebuffer_index(frameBuffer, rowX + j, y);
+
+                // Make depth test
+                zAct = leftSide[y].z + zStep * j;
+                R8DepthBuffer depth = r8_framebuffer_frame_depth(frameBuffer, r8_pixel_write_depth(zAct));
+                R8DepthBuffer oldDepth = r8_framebuffer_read_depth(frameBuffer, pixel);
+
+                if (depth > oldDepth)
+                {
+                    if (tile != NULL)
+                        r8_framebuffer_hiz_write(tile, oldDepth);
+
+                    r8_framebuffer_write_depth(frameBuffer, pixel, depth);
+
+                    if (texels == NULL)
+                    {
+                        R8_FRAMEBUFFER_COLOR(frameBuffer, pixel) = polygon->colorIndex;
+                        continue;
+                    }
+
+                    #ifdef R8_PERSPECTIVE_CORRECTED
+                    if (j >= spanEnd)
+                    {
+                        /*
+                        Compute perspective corrected texture coordinates at both ends of the span which contains the current pixel.
+                        Spans are aligned to the scanline start, so a scanline which is split between several tiles is rasterized the same way.
+                        */
+                        const R8int nextStart = j - j % spanSize;
+
+                        if (nextStart == spanEnd)
+                        {
+                            uSpan = uNext;
+                            vSpan = vNext;
+                        }
+                        else
+                            _perspective_texcoord(&leftSide[y], zStep, uStep, vStep, nextStart, &uSpan, &vSpan);
+
+                        spanStart = nextStart;
+                        spanEnd = spanStart + spanSize;
+
+                        // Last span ends at the scanline end
+                        const R8int spanLast = R8_MIN(spanEnd, len);
+
+                        _perspective_texcoord(&leftSide[y], zStep, uStep, vStep, spanLast, &uNext, &vNext);
+
+                        z = (spanLast > spanStart ? R8_FLOAT(1.0) / (spanLast - spanStart) : R8_FLOAT(0.0));
+                        uSpanStep = (uNext - uSpan) * z;
+                        vSpanStep = (vNext - vSpan) * z;
+
+                        if (polygon->mipPow2)
+                        {
+                            // Step along the span in 16.16 fixed point
+                            uFixed = r8_texture_fixed_coord(uSpan, polygon->mipWidth);
+                            vFixed = r8_texture_fixed_coord(vSpan, polygon->mipHeight);
+                            uFixedStep = r8_texture_fixed_step(uSpanStep, polygon->mipWidth);
+                            vFixedStep = r8_texture_fixed_step(vSpanStep, polygon->mipHeight);
+                        }
+                    }
+
+                    if (polygon->mipPow2)
+                    {
+                        R8_FRAMEBUFFER_COLOR(frameBuffer, pixel) = r8_texture_sample_nearest_pow2(
+                            texels, polygon->mipWidthShift, mipWidthMask, mipHeightMask,
+                            uFixed + uFixedStep * (R8uint)(j - spanStart),
+                            vFixed + vFixedStep * (R8uint)(j - spanStart)
+                        );
+                        continue;
+                    }
+
+                    // Interpolate texture coordinates linearly inside the span
+                    u = uSpan + uSpanStep * (j - spanStart);
+                    v = vSpan + vSpanStep * (j - spanStart);
+                    #else
+                    R8interp uAct = leftSide[y].u + uStep * j;
+                    R8interp vAct = leftSide[y].v + vStep * j;
+
+                    z = zAct;
+                    u = uAct;
+                    v = vAct;
+                    #endif
+
+                    // Sample texture
+                    R8_FRAMEBUFFER_COLOR(frameBuffer, pixel) = r8_texture_sample_nearest_from_mipmap(texels, polygon->mipWidth, polygon->mipHeight, (R8float)u, (R8float)v);
+                }
+            }
         }
     }
+
+    if (rejectedSpans > 0)
+    {
+        r8_atomic_add(&(frameBuffer->hizRejectedSpans), rejectedSpans);
+        r8_atomic_add(&(frameBuffer->hizRejectedPixels), rejectedPixels);
+    }
 }
 
 // Rasterizes convex polygon outlines
-static void _rasterize_polygon_line(R8FrameBuffer* frameBuffer, const R8Texture* texture, R8ubyte mipLevel)
+static void _rasterize_polygon_line(R8FrameBuffer* frameBuffer, const R8RasterPolygon* polygon, const R8Rect* rect)
 {
-    for (R8int i = 0; i + 1 < _numPolyVerts; ++i)
-        _rasterize_line(frameBuffer, texture, mipLevel, i, i + 1);
-    _rasterize_line(frameBuffer, texture, mipLevel, _numPolyVerts - 1, 0);
+    for (R8int i = 0; i + 1 < polygon->numVertices; ++i)
+        _rasterize_line(frameBuffer, polygon, i, i + 1, rect);
+    _rasterize_line(frameBuffer, polygon, polygon->numVertices - 1, 0, rect);
 }
 
 // Rasterizes convex polygon points
-static void _rasterize_polygon_point(
-    R8FrameBuffer* frameBuffer, const R8Texture* texture, R8ubyte mipLevel)
+static void _rasterize_polygon_point(R8FrameBuffer* frameBuffer, const R8RasterPolygon* polygon, const R8Rect* rect)
 {
-    for (R8int i = 0; i < _numPolyVerts; ++i)
+    for (R8int i = 0; i < polygon->numVertices; ++i)
     {
-        r8_framebuffer_plot(
-            frameBuffer,
-            _rasterVertices[i].x,
-            _rasterVertices[i].y,
-            R8_STATE_MACHINE.color0
-        );
+        const R8RasterVertex* vertex = &(polygon->vertices[i]);
+        if (vertex->x >= rect->left && vertex->x <= rect->right && vertex->y >= rect->top && vertex->y <= rect->bottom)
+            r8_framebuffer_plot(frameBuffer, vertex->x, vertex->y, polygon->colorIndex);
     }
 }
 
-static void _rasterize_polygon(R8FrameBuffer* frameBuffer, const R8Texture* texture, R8ubyte mipLevel)
+void r8_render_raster_polygon(
+    R8FrameBuffer* frameBuffer, const R8RasterPolygon* polygon, R8ScalineSide* scanlinesStart, R8ScalineSide* scanlinesEnd, const R8Rect* tileRect)
 {
+    // Clamp rasterization to the clipping rectangle of the polygon (polygons inside the guard band are not clipped geometrically)
+    R8Rect clampedRect;
+    const R8Rect* rect = &clampedRect;
+
+    clampedRect.left    = R8_MAX(tileRect->left, polygon->clipRect.left);
+    clampedRect.top     = R8_MAX(tileRect->top, polygon->clipRect.top);
+    clampedRect.right   = R8_MIN(tileRect->right, polygon->clipRect.right);
+    clampedRect.bottom  = R8_MIN(tileRect->bottom, polygon->clipRect.bottom);
+
+    if (clampedRect.left > clampedRect.right || clampedRect.top > clampedRect.bottom)
+        return;
+
+    if (frameBuffer->pendingClearFlags != 0)
+    {
+        // Apply pending clears inside the polygon bounds (with one pixel tolerance for rounded scanline offsets)
+        R8Rect bounds;
+        bounds.left     = bounds.right  = polygon->vertices[0].x;
+        bounds.top      = bounds.bottom = polygon->vertices[0].y;
+
+        for (R8int i = 1; i < polygon->numVertices; ++i)
+        {
+            R8_CLAMP_SMALLEST(bounds.left, polygon->vertices[i].x);
+            R8_CLAMP_LARGEST(bounds.right, polygon->vertices[i].x);
+            R8_CLAMP_SMALLEST(bounds.top, polygon->vertices[i].y);
+            R8_CLAMP_LARGEST(bounds.bottom, polygon->vertices[i].y);
+        }
+
+        _resolve_rect(
+            frameBuffer,
+            R8_MAX(bounds.left - 1, rect->left),
+            R8_MAX(bounds.top - 1, rect->top),
+            R8_MIN(bounds.right + 1, rect->right),
+            R8_MIN(bounds.bottom + 1, rect->bottom)
+        );
+    }
+
     // Rasterize polygon with selected MIP level
-    switch (R8_STATE_MACHINE.polygonMode)
+    switch (polygon->polygonMode)
     {
         case R8_POLYGON_FILL:
-            _rasterize_polygon_fill(frameBuffer, texture, mipLevel);
+            // Fall back to scanline rasterizer if the polygon is too large for the half-space rasterizer
+            if (polygon->halfSpace == R8_FALSE || r8_halfspace_rasterize_polygon(frameBuffer, polygon, rect) == R8_FALSE)
+                _rasterize_polygon_fill(frameBuffer, polygon, scanlinesStart, scanlinesEnd, rect);
             break;
         case R8_POLYGON_LINE:
-            _rasterize_polygon_line(frameBuffer, texture, mipLevel);
+            _rasterize_polygon_line(frameBuffer, polygon, rect);
             break;
         case R8_POLYGON_POINT:
-            _rasterize_polygon_point(frameBuffer, texture, mipLevel);
+            _rasterize_polygon_point(frameBuffer, polygon, rect);
             break;
     }
 }
 
+static void _rasterize_polygon(R8FrameBuffer* frameBuffer, const R8Texture* texture, R8ubyte mipLevel)
+{
+    // Setup raster polygon from active polygon vertices
+    R8RasterPolygon polygon;
+
+    polygon.vertices        = _rasterVertices;
+    polygon.numVertices     = _numPolyVerts;
+    polygon.polygonMode     = R8_STATE_MACHINE.polygonMode;
+    polygon.halfSpace       = R8_STATE_MACHINE.states[R8_HALF_SPACE];
+    polygon.hierarchicalZ   = R8_STATE_MACHINE.states[R8_HIERARCHICAL_Z];
+    polygon.colorIndex      = R8_STATE_MACHINE.color0;
+    polygon.clipRect        = R8_STATE_MACHINE.clipRect;
+    polygon.mipWidth        = 0;
+    polygon.mipHeight       = 0;
+    polygon.mipPow2         = R8_FALSE;
+    polygon.mipWidthShift   = 0;
+
+    if (texture == &R8_SINGULAR_TEXTURE)
+        polygon.texels = NULL;
+    else
+    {
+        polygon.texels = r8_texture_select_miplevel(texture, mipLevel, &(polygon.mipWidth), &(polygon.mipHeight));
+
+        // Use fixed-point texel coordinates and bit masks for power-of-two textures
+        if (texture->pow2 && polygon.mipWidth > 0 && polygon.mipHeight > 0)
+        {
+            polygon.mipPow2         = R8_TRUE;
+            polygon.mipWidthShift   = r8_texture_size_shift(polygon.mipWidth);
+        }
+    }
+
+    if (r8_tile_binner_active())
+    {
+        // Defer rasterization to the worker threads
+        r8_tile_binner_submit(frameBuffer, &polygon);
+    }
+    else
+    {
+        // Rasterize polygon immediately into the entire frame buffer
+        R8Rect rect;
+        rect.left   = 0;
+        rect.top    = 0;
+        rect.right  = (R8int)frameBuffer->width - 1;
+        rect.bottom = (R8int)frameBuffer->height - 1;
+
+        r8_render_raster_polygon(frameBuffer, &polygon, frameBuffer->scanlinesStart, frameBuffer->scanlinesEnd, &rect);
+    }
+}
+
+/*
+Edge clipping (only for polygons which exceed the guard band).
+All other polygons are clamped to the clipping rectangle by the rasterizers.
+*/
+static R8boolean _polygon_guard_band_clipping(R8uint outcodeOr)
+{
+    if ((outcodeOr & OUTCODE_GUARD) != 0)
+    {
+        _polygon_xy_clipping(
+            R8_STATE_MACHINE.clipRect.left,
+            R8_STATE_MACHINE.clipRect.right,
+            R8_STATE_MACHINE.clipRect.top,
+            R8_STATE_MACHINE.clipRect.bottom
+        );
+
+        if (_numPolyVerts < 3)
+            return R8_FALSE;
+    }
+    return R8_TRUE;
+}
+
 static R8boolean _clip_and_r8oject_polygon(R8int numVertices)
 {
-    // Get clipping rectangle
-    const R8int xMin = R8_STATE_MACHINE.clipRect.left;
-    const R8int xMax = R8_STATE_MACHINE.clipRect.right;
-    const R8int yMin = R8_STATE_MACHINE.clipRect.top;
-    const R8int yMax = R8_STATE_MACHINE.clipRect.bottom;
+    // Classify vertices against the view volume in clip space
+    R8uint outcodeAnd = ~0u, outcodeOr = 0;
 
-    // Z clipping
-    _numPolyVerts = numVertices;
-    _polygon_z_clipping(1.0f, 100.0f);//!!!
-    //_polygon_z_clipping(0.01f, 100.0f);//!!!
+    for (R8int j = 0; j < numVertices; ++j)
+    {
+        const R8uint outcode = _compute_outcode(&(_clipVertices[j]), R8_STATE_MACHINE.clipBounds, R8_STATE_MACHINE.guardBandBounds);
+        outcodeAnd &= outcode;
+        outcodeOr |= outcode;
+    }
 
-    if (_numPolyVerts < 3)
+    // Reject polygon entirely outside of one plane before projection
+    if (outcodeAnd != 0)
         return R8_FALSE;
 
+    // Z clipping (only for polygons which cross the near or far plane)
+    _numPolyVerts = numVertices;
+
+    if ((outcodeOr & OUTCODE_Z) != 0)
+    {
+        _polygon_z_clipping();
+        if (_numPolyVerts < 3)
+            return R8_FALSE;
+    }
+
     // Projection
     for (R8int j = 0; j < _numPolyVerts; ++j)
         _r8oject_vertex(&(_clipVertices[j]), &(R8_STATE_MACHINE.viewport));
@@ -975,13 +1880,7 @@ static R8boolean _clip_and_r8oject_polygon(R8int numVertices)
     for (R8int j = 0; j < _numPolyVerts; ++j)
         _setup_raster_vertex(&(_rasterVertices[j]), &(_clipVertices[j]));
 
-    // Edge clipping
-    _polygon_xy_clipping(xMin, xMax, yMin, yMax);
-
-    if (_numPolyVerts < 3)
-        return R8_FALSE;
-
-    return R8_TRUE;
+    return _polygon_guard_band_clipping(outcodeOr);
 }
 
 static R8ubyte _compute_polygon_miplevel(const R8Texture* texture)
@@ -1011,18 +1910,19 @@ static void _render_triangles(
     // Get clipping dimensions
     R8FrameBuffer* frameBuffer = R8_STATE_MACHINE.boundFrameBuffer;
 
-    // Iterate over the index buffer
-    for (R8sizei i = firstVertex, n = numVertices + firstVertex; i + 2 < n; i += 3)
+    // Iterate over the vertex buffer
+    for (R8sizei i = 0; i + 2 < numVertices; i += 3)
     {
-        // Fetch vertices
-        const R8Vertex* vertexA = (vertexBuffer->vertices + i);
-        const R8Vertex* vertexB = (vertexBuffer->vertices + (i + 1));
-        const R8Vertex* vertexC = (vertexBuffer->vertices + (i + 2));
+        // Transform vertices in batches of bounded size (the batch size is a multiple of 3, so triangles never straddle two batches)
+        const R8sizei batchIndex = i % R8_MAX_BATCH_VERTICES;
+
+        if (batchIndex == 0)
+            _transform_vertices(R8_MIN(numVertices - i, R8_MAX_BATCH_VERTICES), firstVertex + i, vertexBuffer);
 
         // Setup polygon
-        _transform_vertex(&(_clipVertices[0]), vertexA);
-        _transform_vertex(&(_clipVertices[1]), vertexB);
-        _transform_vertex(&(_clipVertices[2]), vertexC);
+        _fetch_vertex(&(_clipVertices[0]), vertexBuffer, batchIndex, firstVertex + i);
+        _fetch_vertex(&(_clipVertices[1]), vertexBuffer, batchIndex + 1, firstVertex + i + 1);
+        _fetch_vertex(&(_clipVertices[2]), vertexBuffer, batchIndex + 2, firstVertex + i + 2);
 
         if (_clip_and_r8oject_polygon(3) != R8_FALSE)
         {
@@ -1044,12 +1944,15 @@ void r8_render_triangles(R8sizei numVertices, R8sizei firstVertex, const R8Verte
         R8_ERROR(R8_ERROR_NULL_POINTER);
         return;
     }
-    if (firstVertex + numVertices > vertexBuffer->numVertices)
+    if (!_is_valid_range(firstVertex, numVertices, vertexBuffer->numVertices))
     {
         R8_ERROR(R8_ERROR_INVALID_ARGUMENT);
         return;
     }
 
+    if (_is_draw_culled(vertexBuffer))
+        return;
+
     R8Texture* texture = R8_STATE_MACHINE.boundTexture;
     if (texture == NULL || texture->texels == NULL)
     {
@@ -1060,47 +1963,208 @@ void r8_render_triangles(R8sizei numVertices, R8sizei firstVertex, const R8Verte
         _render_triangles(texture, numVertices, firstVertex, vertexBuffer);
 }
 
-void r8_render_triangle_strip(R8sizei numVertices, R8sizei firstVertex, const R8VertexBuffer* vertexBuffer)
+//! Vertex of a triangle strip or fan, which is set up once and shared by all triangles it belongs to.
+typedef struct R8SetupVertex
 {
-    //...
+    R8ClipVertex    clipVertex;     // Transformed vertex (before clipping).
+    R8uint          outcode;        // Outcode of the transformed vertex (see '_compute_outcode').
+    R8ClipVertex    screenVertex;   // Projected vertex. Only valid if the vertex needs no Z clipping.
+    R8RasterVertex  rasterVertex;   // Raster vertex of the projected vertex. Only valid if the vertex needs no Z clipping.
 }
+R8SetupVertex;
 
-void r8_render_triangle_fan(R8sizei numVertices, R8sizei firstVertex, const R8VertexBuffer* vertexBuffer)
+// Computes the outcode and (unless it must be clipped against the near or far plane) the projected and raster vertex of the transformed vertex.
+static void _setup_vertex(R8SetupVertex* setupVert)
 {
-    //...
+    setupVert->outcode = _compute_outcode(&(setupVert->clipVertex), R8_STATE_MACHINE.clipBounds, R8_STATE_MACHINE.guardBandBounds);
+
+    if ((setupVert->outcode & OUTCODE_Z) == 0)
+    {
+        setupVert->screenVertex = setupVert->clipVertex;
+        _r8oject_vertex(&(setupVert->screenVertex), &(R8_STATE_MACHINE.viewport));
+        _setup_raster_vertex(&(setupVert->rasterVertex), &(setupVert->screenVertex));
+    }
 }
 
-static void _render_indexed_triangles(
-    const R8Texture* texture, R8sizei numVertices, R8sizei firstVertex, const R8VertexBuffer* vertexBuffer, const R8IndexBuffer* indexBuffer)
+/*
+Same as '_clip_and_r8oject_polygon' for a triangle of set up vertices. The projection and raster setup of the two vertices,
+which are shared with the previous triangle of a strip or fan, is reused and only redone for triangles which need Z clipping.
+*/
+static R8boolean _clip_and_r8oject_setup_triangle(const R8SetupVertex* a, const R8SetupVertex* b, const R8SetupVertex* c)
+{
+    const R8uint outcodeAnd = (a->outcode & b->outcode & c->outcode);
+    const R8uint outcodeOr = (a->outcode | b->outcode | c->outcode);
+
+    if (outcodeAnd != 0)
+        return R8_FALSE;
+
+    if ((outcodeOr & OUTCODE_Z) != 0)
+    {
+        _clipVertices[0] = a->clipVertex;
+        _clipVertices[1] = b->clipVertex;
+        _clipVertices[2] = c->clipVertex;
+        return _clip_and_r8oject_polygon(3);
+    }
+
+    _numPolyVerts = 3;
+
+    _clipVertices[0] = a->screenVertex;
+    _clipVertices[1] = b->screenVertex;
+    _clipVertices[2] = c->screenVertex;
+
+    if (_is_triangle_culled(_CVERT_VEC2(0), _CVERT_VEC2(1), _CVERT_VEC2(2)))
+        return R8_FALSE;
+
+    _rasterVertices[0] = a->rasterVertex;
+    _rasterVertices[1] = b->rasterVertex;
+    _rasterVertices[2] = c->rasterVertex;
+
+    return _polygon_guard_band_clipping(outcodeOr);
+}
+
+// Returns the slot in the assembly window for the k-th vertex (since the last restart) of a triangle strip or fan.
+R8_INLINE R8int _assembly_slot(R8enum primitives, R8int k)
+{
+    if (primitives == R8_TRIANGLE_STRIP)
+        return k % 3;
+    else
+        return (k == 0 ? 0 : 1 + (k - 1) % 2);
+}
+
+/*
+Renders the triangle, which is completed by the k-th vertex (since the last restart) of a triangle strip or fan.
+The window holds the last three vertices of a strip, or the first and the last two vertices of a fan (see '_assembly_slot').
+Every odd triangle of a strip swaps its first two vertices to keep the winding order of the strip.
+*/
+static void _assemble_triangle(
+    R8FrameBuffer* frameBuffer, const R8Texture* texture, R8enum primitives, const R8SetupVertex* window, R8int k)
+{
+    if (k < 2)
+        return;
+
+    const R8SetupVertex* a = &(window[primitives == R8_TRIANGLE_STRIP ? (k - 2) % 3 : 0]);
+    const R8SetupVertex* b = &(window[_assembly_slot(primitives, k - 1)]);
+    const R8SetupVertex* c = &(window[_assembly_slot(primitives, k)]);
+
+    if (primitives == R8_TRIANGLE_STRIP && (k & 1) != 0)
+    {
+        const R8SetupVertex* tmp = a;
+        a = b;
+        b = tmp;
+    }
+
+    if (_clip_and_r8oject_setup_triangle(a, b, c) != R8_FALSE)
+    {
+        // Rasterize active polygon
+        _rasterize_polygon(frameBuffer, texture, _compute_polygon_miplevel(texture));
+    }
+}
+
+static void _render_connected_triangles(
+    const R8Texture* texture, R8enum primitives, R8sizei numVertices, R8sizei firstVertex, const R8VertexBuffer* vertexBuffer)
 {
-    // Get clipping dimensions
     R8FrameBuffer* frameBuffer = R8_STATE_MACHINE.boundFrameBuffer;
+    R8SetupVertex window[3];
 
-    // Iterate over the index buffer
-    for (R8sizei i = firstVertex, n = numVertices + firstVertex; i + 2 < n; i += 3)
+    for (R8sizei i = 0; i < numVertices; ++i)
+    {
+        // Transform vertices in batches of bounded size (shared vertices are kept in the window across batches)
+        const R8sizei batchIndex = i % R8_MAX_BATCH_VERTICES;
+
+        if (batchIndex == 0)
+            _transform_vertices(R8_MIN(numVertices - i, R8_MAX_BATCH_VERTICES), firstVertex + i, vertexBuffer);
+
+        // Setup new vertex only once and assemble the triangle it completes
+        R8SetupVertex* setupVert = &(window[_assembly_slot(primitives, (R8int)i)]);
+
+        _fetch_vertex(&(setupVert->clipVertex), vertexBuffer, batchIndex, firstVertex + i);
+        _setup_vertex(setupVert);
+
+        _assemble_triangle(frameBuffer, texture, primitives, window, (R8int)i);
+    }
+}
+
+// Returns the bound texture, or the singular texture with the current color if no texture is bound.
+static const R8Texture* _get_polygon_texture()
+{
+    R8Texture* texture = R8_STATE_MACHINE.boundTexture;
+
+    if (texture == NULL || texture->texels == NULL)
+    {
+        r8_texture_singular_color(&R8_SINGULAR_TEXTURE, R8_STATE_MACHINE.color0);
+        return &R8_SINGULAR_TEXTURE;
+    }
+
+    return texture;
+}
+
+static void _render_triangle_strip_or_fan(R8enum primitives, R8sizei numVertices, R8sizei firstVertex, const R8VertexBuffer* vertexBuffer)
+{
+    if (R8_STATE_MACHINE.boundFrameBuffer == NULL)
+    {
+        R8_ERROR(R8_ERROR_INVALID_STATE);
+        return;
+    }
+    if (vertexBuffer == NULL)
+    {
+        R8_ERROR(R8_ERROR_NULL_POINTER);
+        return;
+    }
+    if (!_is_valid_range(firstVertex, numVertices, vertexBuffer->numVertices))
+    {
+        R8_ERROR(R8_ERROR_INVALID_ARGUMENT);
+        return;
+    }
+
+    if (numVertices < 3 || _is_draw_culled(vertexBuffer))
+        return;
+
+    _render_connected_triangles(_get_polygon_texture(), primitives, numVertices, firstVertex, vertexBuffer);
+}
+
+void r8_render_triangle_strip(R8sizei numVertices, R8sizei firstVertex, const R8VertexBuffer* vertexBuffer)
+{
+    _render_triangle_strip_or_fan(R8_TRIANGLE_STRIP, numVertices, firstVertex, vertexBuffer);
+}
+
+void r8_render_triangle_fan(R8sizei numVertices, R8sizei firstVertex, const R8VertexBuffer* vertexBuffer)
+{
+    _render_triangle_strip_or_fan(R8_TRIANGLE_FAN, numVertices, firstVertex, vertexBuffer);
+}
+
+// Renders the triangles of the index range [first, last) with vertices from the batch, or on demand through the vertex cache.
+static void _render_indexed_triangle_range(
+    R8FrameBuffer* frameBuffer, const R8Texture* texture, R8sizei first, R8sizei last,
+    const R8VertexBuffer* vertexBuffer, const R8IndexBuffer* indexBuffer, R8boolean batched)
+{
+    for (R8sizei i = first; i + 2 < last; i += 3)
     {
         // Fetch indices
-        R8ushort indexA = indexBuffer->indices[i];
-        R8ushort indexB = indexBuffer->indices[i + 1];
-        R8ushort indexC = indexBuffer->indices[i + 2];
+        R8uint indexA = r8_indexbuffer_get(indexBuffer, i);
+        R8uint indexB = r8_indexbuffer_get(indexBuffer, i + 1);
+        R8uint indexC = r8_indexbuffer_get(indexBuffer, i + 2);
 
         #ifdef R8_DEBUG
-        if (indexA >= vertexBuffer->numVertices || indexB >= vertexBuffer->numVertices || indexC >= vertexBuffer->numVertices)
+        if (indexA >= (R8uint)vertexBuffer->numVertices || indexB >= (R8uint)vertexBuffer->numVertices || indexC >= (R8uint)vertexBuffer->numVertices)
         {
             R8_SET_ERROR_FATAL("element in index buffer out of bounds");
             return;
         }
         #endif
 
-        // Fetch vertices
-        const R8Vertex* vertexA = (vertexBuffer->vertices + indexA);
-        const R8Vertex* vertexB = (vertexBuffer->vertices + indexB);
-        const R8Vertex* vertexC = (vertexBuffer->vertices + indexC);
-
-        // Setup polygon
-        _transform_vertex(&(_clipVertices[0]), vertexA);
-        _transform_vertex(&(_clipVertices[1]), vertexB);
-        _transform_vertex(&(_clipVertices[2]), vertexC);
+        // Setup polygon (vertices which are shared with recent triangles are reused from the vertex cache)
+        if (batched)
+        {
+            _fetch_vertex(&(_clipVertices[0]), vertexBuffer, indexA, indexA);
+            _fetch_vertex(&(_clipVertices[1]), vertexBuffer, indexB, indexB);
+            _fetch_vertex(&(_clipVertices[2]), vertexBuffer, indexC, indexC);
+        }
+        else
+        {
+            _vertex_cache_fetch(&(_clipVertices[0]), vertexBuffer, indexA);
+            _vertex_cache_fetch(&(_clipVertices[1]), vertexBuffer, indexB);
+            _vertex_cache_fetch(&(_clipVertices[2]), vertexBuffer, indexC);
+        }
 
         if (_clip_and_r8oject_polygon(3) != R8_FALSE)
         {
@@ -1110,6 +2174,106 @@ static void _render_indexed_triangles(
     }
 }
 
+// Returns R8_TRUE if the meshlets of the index buffer can be used to draw the index range with the vertex buffer.
+static R8boolean _has_valid_meshlets(R8sizei firstVertex, const R8VertexBuffer* vertexBuffer, const R8IndexBuffer* indexBuffer)
+{
+    return
+    (
+        indexBuffer->meshlets != NULL &&
+        indexBuffer->meshletVertexBuffer == vertexBuffer &&
+        indexBuffer->meshletGeneration == vertexBuffer->generation &&
+        firstVertex % 3 == 0
+    );
+}
+
+/*
+Renders the index range meshlet by meshlet. A meshlet is rejected before any of its vertices is transformed,
+if its bounding sphere is outside of the view volume or if all of its triangles are culled (see 'r8_meshlet_backfacing').
+*/
+static void _render_indexed_meshlets(
+    R8FrameBuffer* frameBuffer, const R8Texture* texture, R8sizei numVertices, R8sizei firstVertex,
+    const R8VertexBuffer* vertexBuffer, const R8IndexBuffer* indexBuffer)
+{
+    R8Frustum frustum;
+    r8_frustum_setup(&frustum, &(R8_STATE_MACHINE.worldViewProjectionMatrix), R8_STATE_MACHINE.clipBounds);
+
+    R8float camera[4];
+    r8_meshlet_camera(camera, &(R8_STATE_MACHINE.worldViewProjectionMatrix));
+
+    /*
+    The screen space orientation of a triangle is the sign of dot(plane, camera), flipped by the viewport
+    if exactly one of its axes is mirrored (see '_is_triangle_culled').
+    */
+    R8float facing = 0.0f;
+
+    if (R8_STATE_MACHINE.cullMode != R8_CULL_NONE)
+    {
+        facing = (R8_STATE_MACHINE.viewport.halfWidth * R8_STATE_MACHINE.viewport.halfHeight > 0.0f ? 1.0f : -1.0f);
+        if (R8_STATE_MACHINE.cullMode == R8_CULL_BACK)
+            facing = -facing;
+    }
+
+    const R8sizei last = firstVertex + numVertices;
+
+    for (R8sizei m = firstVertex / R8_MESHLET_INDICES; m < indexBuffer->numMeshlets; ++m)
+    {
+        const R8Meshlet* meshlet = &(indexBuffer->meshlets[m]);
+
+        if (meshlet->firstIndex >= last)
+            break;
+
+        if (r8_frustum_cull_sphere(&frustum, meshlet->center, meshlet->radius) ||
+            (facing != 0.0f && r8_meshlet_backfacing(meshlet, camera, facing)))
+        {
+            ++frameBuffer->culledMeshlets;
+            continue;
+        }
+
+        _render_indexed_triangle_range(
+            frameBuffer,
+            texture,
+            R8_MAX(firstVertex, meshlet->firstIndex),
+            R8_MIN(last, meshlet->firstIndex + meshlet->numIndices),
+            vertexBuffer,
+            indexBuffer,
+            R8_FALSE
+        );
+    }
+}
+
+static void _render_indexed_triangles(
+    const R8Texture* texture, R8sizei numVertices, R8sizei firstVertex, const R8VertexBuffer* vertexBuffer, const R8IndexBuffer* indexBuffer)
+{
+    // Get clipping dimensions
+    R8FrameBuffer* frameBuffer = R8_STATE_MACHINE.boundFrameBuffer;
+
+    _vertex_cache_reset();
+
+    // Reject entire triangle clusters if the index buffer has meshlets for this vertex buffer (their vertices are transformed on demand)
+    if (_has_valid_meshlets(firstVertex, vertexBuffer, indexBuffer))
+    {
+        _render_indexed_meshlets(frameBuffer, texture, numVertices, firstVertex, vertexBuffer, indexBuffer);
+        _vertex_cache_submit_statistics(frameBuffer);
+        return;
+    }
+
+    // Transform the entire vertex buffer in a batch if the draw call references at least as many vertices as it contains,
+    // otherwise (or if the vertex buffer exceeds the batch size) only transform the referenced vertices on demand through the post-transform vertex cache
+    const R8boolean batched = (numVertices >= vertexBuffer->numVertices && vertexBuffer->numVertices <= R8_MAX_BATCH_VERTICES);
+
+    if (batched)
+    {
+        _transform_vertices(vertexBuffer->numVertices, 0, vertexBuffer);
+        _vertexCacheMisses = (R8int)vertexBuffer->numVertices;
+        _vertexCacheHits = R8_MAX(0, (R8int)(numVertices - numVertices % 3) - _vertexCacheMisses);
+    }
+
+    // Iterate over the index buffer
+    _render_indexed_triangle_range(frameBuffer, texture, firstVertex, firstVertex + numVertices, vertexBuffer, indexBuffer, batched);
+
+    _vertex_cache_submit_statistics(frameBuffer);
+}
+
 void r8_render_indexed_triangles(R8sizei numVertices, R8sizei firstVertex, const R8VertexBuffer* vertexBuffer, const R8IndexBuffer* indexBuffer)
 {
     if (R8_STATE_MACHINE.boundFrameBuffer == NULL)
@@ -1122,12 +2286,15 @@ void r8_render_indexed_triangles(R8sizei numVertices, R8sizei firstVertex, const
         R8_ERROR(R8_ERROR_NULL_POINTER);
         return;
     }
-    if (firstVertex + numVertices > indexBuffer->numIndices)
+    if (!_is_valid_range(firstVertex, numVertices, indexBuffer->numIndices))
     {
         R8_ERROR(R8_ERROR_INVALID_ARGUMENT);
         return;
     }
 
+    if (_is_draw_culled(vertexBuffer))
+        return;
+
     if (R8_STATE_MACHINE.boundTexture == NULL)
     {
         r8_texture_singular_color(&R8_SINGULAR_TEXTURE, R8_STATE_MACHINE.color0);
@@ -1137,13 +2304,270 @@ void r8_render_indexed_triangles(R8sizei numVertices, R8sizei firstVertex, const
         _render_indexed_triangles(R8_STATE_MACHINE.boundTexture, numVertices, firstVertex, vertexBuffer, indexBuffer);
 }
 
+static void _render_indexed_connected_triangles(
+    const R8Texture* texture, R8enum primitives, R8sizei numVertices, R8sizei firstVertex,
+    const R8VertexBuffer* vertexBuffer, const R8IndexBuffer* indexBuffer)
+{
+    R8FrameBuffer* frameBuffer = R8_STATE_MACHINE.boundFrameBuffer;
+    R8SetupVertex window[3];
+
+    const R8boolean restart = R8_STATE_MACHINE.states[R8_PRIMITIVE_RESTART];
+    const R8uint restartIndex = _primitive_restart_index(indexBuffer);
+
+    _vertex_cache_reset();
+
+    // Number of vertices since the last restart
+    R8int k = 0;
+
+    for (R8sizei i = firstVertex, n = numVertices + firstVertex; i < n; ++i)
+    {
+        const R8uint index = r8_indexbuffer_get(indexBuffer, i);
+
+        // Start a new strip or fan at the primitive restart index
+        if (restart && index == restartIndex)
+        {
+            k = 0;
+            continue;
+        }
+
+        #ifdef R8_DEBUG
+        if (index >= (R8uint)vertexBuffer->numVertices)
+        {
+            R8_SET_ERROR_FATAL("element in index buffer out of bounds");
+            return;
+        }
+        #endif
+
+        // Setup new vertex only once (vertices which are referenced again are reused from the vertex cache) and assemble the triangle it completes
+        R8SetupVertex* setupVert = &(window[_assembly_slot(primitives, k)]);
+
+        _vertex_cache_fetch(&(setupVert->clipVertex), vertexBuffer, (R8int)index);
+        _setup_vertex(setupVert);
+
+        _assemble_triangle(frameBuffer, texture, primitives, window, k++);
+    }
+
+    _vertex_cache_submit_statistics(frameBuffer);
+}
+
+static void _render_indexed_triangle_strip_or_fan(
+    R8enum primitives, R8sizei numVertices, R8sizei firstVertex, const R8VertexBuffer* vertexBuffer, const R8IndexBuffer* indexBuffer)
+{
+    if (R8_STATE_MACHINE.boundFrameBuffer == NULL)
+    {
+        R8_ERROR(R8_ERROR_INVALID_STATE);
+        return;
+    }
+    if (vertexBuffer == NULL || indexBuffer == NULL)
+    {
+        R8_ERROR(R8_ERROR_NULL_POINTER);
+        return;
+    }
+    if (!_is_valid_range(firstVertex, numVertices, indexBuffer->numIndices))
+    {
+        R8_ERROR(R8_ERROR_INVALID_ARGUMENT);
+        return;
+    }
+
+    if (numVertices < 3 || _is_draw_culled(vertexBuffer))
+        return;
+
+    _render_indexed_connected_triangles(_get_polygon_texture(), primitives, numVertices, firstVertex, vertexBuffer, indexBuffer);
+}
+
 void r8_render_indexed_triangle_strip(R8sizei numVertices, R8sizei firstVertex, const R8VertexBuffer* vertexBuffer, const R8IndexBuffer* indexBuffer)
 {
-    //...
+    _render_indexed_triangle_strip_or_fan(R8_TRIANGLE_STRIP, numVertices, firstVertex, vertexBuffer, indexBuffer);
 }
 
 void r8_render_indexed_triangle_fan(R8sizei numVertices, R8sizei firstVertex, const R8VertexBuffer* vertexBuffer, const R8IndexBuffer* indexBuffer)
 {
-    //...
+    _render_indexed_triangle_strip_or_fan(R8_TRIANGLE_FAN, numVertices, firstVertex, vertexBuffer, indexBuffer);
+}
+
+// --- instances --- //
+
+/*
+Renders indexed lines or triangles with the current world-view-projection matrix (the draw call has already been validated).
+Lines are colored with the current color if 'texture' is the singular texture.
+*/
+static void _render_indexed_primitives(
+    const R8Texture* texture, R8enum primitives, R8sizei numVertices, R8sizei firstVertex,
+    const R8VertexBuffer* vertexBuffer, const R8IndexBuffer* indexBuffer)
+{
+    switch (primitives)
+    {
+        case R8_LINES:
+        case R8_LINE_STRIP:
+        case R8_LINE_LOOP:
+            if (numVertices >= 2)
+            {
+                // Lines are not binned, so binned polygons must be rasterized first
+                r8_tile_binner_flush();
+                _render_line_segments(
+                    (texture != &R8_SINGULAR_TEXTURE ? texture : NULL), primitives, numVertices, firstVertex, vertexBuffer, indexBuffer
+                );
+            }
+            break;
+
+        case R8_TRIANGLES:
+            _render_indexed_triangles(texture, numVertices, firstVertex, vertexBuffer, indexBuffer);
+            break;
+        case R8_TRIANGLE_STRIP:
+        case R8_TRIANGLE_FAN:
+            if (numVertices >= 3)
+                _render_indexed_connected_triangles(texture, primitives, numVertices, firstVertex, vertexBuffer, indexBuffer);
+            break;
+    }
+}
+
+void r8_render_indexed_instanced(
+    R8enum primitives, R8sizei numVertices, R8sizei firstVertex, R8sizei numInstances, const R8Matrix4* worldMatrices,
+    const R8VertexBuffer* vertexBuffer, const R8IndexBuffer* indexBuffer)
+{
+    if (R8_STATE_MACHINE.boundFrameBuffer == NULL)
+    {
+        R8_ERROR(R8_ERROR_INVALID_STATE);
+        return;
+    }
+    if (vertexBuffer == NULL || indexBuffer == NULL || worldMatrices == NULL)
+    {
+        R8_ERROR(R8_ERROR_NULL_POINTER);
+        return;
+    }
+    // Indexed points are not supported
+    if (primitives < R8_LINES || primitives > R8_TRIANGLE_FAN || numInstances < 0 || !_is_valid_range(firstVertex, numVertices, indexBuffer->numIndices))
+    {
+        R8_ERROR(R8_ERROR_INVALID_ARGUMENT);
+        return;
+    }
+
+    const R8Texture* texture = _get_polygon_texture();
+
+    // Render instances with their own world-view-projection matrix and restore the matrix of the state machine afterwards
+    const R8Matrix4 worldViewProjectionMatrix = R8_STATE_MACHINE.worldViewProjectionMatrix;
+    R8Matrix4 instanceMatrices[R8_MAX_BATCH_INSTANCES];
+
+    for (R8sizei first = 0; first < numInstances; first += R8_MAX_BATCH_INSTANCES)
+    {
+        const R8sizei count = R8_MIN(numInstances - first, R8_MAX_BATCH_INSTANCES);
+
+        r8_matrix_mul_matrices(instanceMatrices, &(R8_STATE_MACHINE.viewProjectionMatrix), &(worldMatrices[first]), count);
+
+        for (R8sizei i = 0; i < count; ++i)
+        {
+            R8_STATE_MACHINE.worldViewProjectionMatrix = instanceMatrices[i];
+
+            if (!_is_draw_culled(vertexBuffer))
+                _render_indexed_primitives(texture, primitives, numVertices, firstVertex, vertexBuffer, indexBuffer);
+        }
+    }
+
+    R8_STATE_MACHINE.worldViewProjectionMatrix = worldViewProjectionMatrix;
+}
+
+// --- multi draw --- //
+
+// Returns the texture of the specified range, or the singular texture if the range has no texture (its color must already be set).
+R8_INLINE const R8Texture* _get_range_texture(const R8Texture* const* textures, R8sizei range, const R8Texture* defaultTexture)
+{
+    if (textures == NULL)
+        return defaultTexture;
+
+    const R8Texture* texture = textures[range];
+
+    if (texture == NULL || texture->texels == NULL)
+        return &R8_SINGULAR_TEXTURE;
+
+    return texture;
+}
+
+// Renders all triangle list ranges with a single vertex transformation pass (or a single post-transform vertex cache).
+static void _render_indexed_triangle_ranges(
+    const R8Texture* defaultTexture, R8sizei numRanges, const R8sizei* firstVertices, const R8sizei* numVertices,
+    const R8Texture* const* textures, R8sizei numTotalVertices, const R8VertexBuffer* vertexBuffer, const R8IndexBuffer* indexBuffer)
+{
+    R8FrameBuffer* frameBuffer = R8_STATE_MACHINE.boundFrameBuffer;
+
+    _vertex_cache_reset();
+
+    // Ranges share the same transformed vertices, so the whole batch decides whether the vertex buffer is transformed at once
+    const R8boolean batched = (numTotalVertices >= vertexBuffer->numVertices && vertexBuffer->numVertices <= R8_MAX_BATCH_VERTICES);
+
+    if (batched)
+    {
+        _transform_vertices(vertexBuffer->numVertices, 0, vertexBuffer);
+        _vertexCacheMisses = (R8int)vertexBuffer->numVertices;
+        _vertexCacheHits = R8_MAX(0, (R8int)numTotalVertices - _vertexCacheMisses);
+    }
+
+    for (R8sizei i = 0; i < numRanges; ++i)
+    {
+        _render_indexed_triangle_range(
+            frameBuffer,
+            _get_range_texture(textures, i, defaultTexture),
+            firstVertices[i],
+            firstVertices[i] + numVertices[i],
+            vertexBuffer,
+            indexBuffer,
+            batched
+        );
+    }
+
+    _vertex_cache_submit_statistics(frameBuffer);
+}
+
+void r8_render_indexed_multi(
+    R8enum primitives, R8sizei numRanges, const R8sizei* firstVertices, const R8sizei* numVertices, const R8Texture* const* textures,
+    const R8VertexBuffer* vertexBuffer, const R8IndexBuffer* indexBuffer)
+{
+    if (R8_STATE_MACHINE.boundFrameBuffer == NULL)
+    {
+        R8_ERROR(R8_ERROR_INVALID_STATE);
+        return;
+    }
+    if (vertexBuffer == NULL || indexBuffer == NULL || firstVertices == NULL || numVertices == NULL)
+    {
+        R8_ERROR(R8_ERROR_NULL_POINTER);
+        return;
+    }
+    // Indexed points are not supported
+    if (primitives < R8_LINES || primitives > R8_TRIANGLE_FAN || numRanges < 0)
+    {
+        R8_ERROR(R8_ERROR_INVALID_ARGUMENT);
+        return;
+    }
+
+    // Validate all ranges before anything is drawn
+    R8sizei numTotalVertices = 0;
+
+    for (R8sizei i = 0; i < numRanges; ++i)
+    {
+        if (!_is_valid_range(firstVertices[i], numVertices[i], indexBuffer->numIndices))
+        {
+            R8_ERROR(R8_ERROR_INVALID_ARGUMENT);
+            return;
+        }
+        numTotalVertices += numVertices[i] - numVertices[i] % 3;
+    }
+
+    // All ranges are drawn with the same matrix, so the bounding volume of the vertex buffer is tested once
+    if (numRanges == 0 || _is_draw_culled(vertexBuffer))
+        return;
+
+    // Select the texture once for all ranges without their own texture
+    const R8Texture* texture = _get_polygon_texture();
+
+    if (textures != NULL)
+        r8_texture_singular_color(&R8_SINGULAR_TEXTURE, R8_STATE_MACHINE.color0);
+
+    if (primitives == R8_TRIANGLES)
+        _render_indexed_triangle_ranges(texture, numRanges, firstVertices, numVertices, textures, numTotalVertices, vertexBuffer, indexBuffer);
+    else
+    {
+        // Ranges of lines and connected triangles go directly to their kernels with the texture of the range (no further validation)
+        for (R8sizei i = 0; i < numRanges; ++i)
+            _render_indexed_primitives(_get_range_texture(textures, i, texture), primitives, numVertices[i], firstVertices[i], vertexBuffer, indexBuffer);
+    }
 }
 
@@ -12,13 +12,17 @@
 #include "r8_types.h"
 #include "r8_vertexbuffer.h"
 #include "r8_indexbuffer.h"
+#include "r8_framebuffer.h"
+#include "r8_texture.h"
+#include "r8_raster_polygon.h"
+#include "r8_rect.h"
 
 
 // --- points --- //
 
 void r8_render_screenspace_point(R8int x, R8int y);
 
-void r8_render_points(R8sizei numVertices, R8sizei firstVertex, /*const */R8VertexBuffer* vertexBuffer);
+void r8_render_points(R8sizei numVertices, R8sizei firstVertex, const R8VertexBuffer* vertexBuffer);
 
 void r8_render_indexed_points(R8sizei numVertices, R8sizei firstVertex, const R8VertexBuffer* vertexBuffer, const R8IndexBuffer* indexBuffer);
 
@@ -30,7 +34,7 @@ void r8_render_lines(R8sizei numVertices, R8sizei firstVertex, const R8VertexBuf
 void r8_render_line_strip(R8sizei numVertices, R8sizei firstVertex, const R8VertexBuffer* vertexBuffer);
 void r8_render_line_loop(R8sizei numVertices, R8sizei firstVertex, const R8VertexBuffer* vertexBuffer);
 
-void r8_render_indexed_lines(R8sizei numVertices, R8sizei firstVertex, /*const */R8VertexBuffer* vertexBuffer, const R8IndexBuffer* indexBuffer);
+void r8_render_indexed_lines(R8sizei numVertices, R8sizei firstVertex, const R8VertexBuffer* vertexBuffer, const R8IndexBuffer* indexBuffer);
 void r8_render_indexed_line_strip(R8sizei numVertices, R8sizei firstVertex, const R8VertexBuffer* vertexBuffer, const R8IndexBuffer* indexBuffer);
 void r8_render_indexed_line_loop(R8sizei numVertices, R8sizei firstVertex, const R8VertexBuffer* vertexBuffer, const R8IndexBuffer* indexBuffer);
 
@@ -48,5 +52,51 @@ void r8_render_indexed_triangles(R8sizei numVertices, R8sizei firstVertex, const
 void r8_render_indexed_triangle_strip(R8sizei numVertices, R8sizei firstVertex, const R8VertexBuffer* vertexBuffer, const R8IndexBuffer* indexBuffer);
 void r8_render_indexed_triangle_fan(R8sizei numVertices, R8sizei firstVertex, const R8VertexBuffer* vertexBuffer, const R8IndexBuffer* indexBuffer);
 
+// --- instances --- //
+
+/**
+Renders the indexed primitives once for each of the 'numInstances' world matrices. The draw call is validated once,
+and the world-view-projection matrices are computed in batches of R8_MAX_BATCH_INSTANCES. The world matrix of the state machine is not modified.
+*/
+void r8_render_indexed_instanced(
+    R8enum primitives,
+    R8sizei numVertices,
+    R8sizei firstVertex,
+    R8sizei numInstances,
+    const R8Matrix4* worldMatrices,
+    const R8VertexBuffer* vertexBuffer,
+    const R8IndexBuffer* indexBuffer
+);
+
+// --- multi draw --- //
+
+/**
+Renders several ranges of the index buffer (with 'firstVertices[i]' and 'numVertices[i]' for each range i) in a single draw call.
+The draw call is validated once, and all ranges of a triangle list share the same vertex transformation. If 'textures' is not null,
+each range is drawn with its own texture (or the current color if its texture is null), otherwise all ranges use the bound texture.
+*/
+void r8_render_indexed_multi(
+    R8enum primitives,
+    R8sizei numRanges,
+    const R8sizei* firstVertices,
+    const R8sizei* numVertices,
+    const R8Texture* const* textures,
+    const R8VertexBuffer* vertexBuffer,
+    const R8IndexBuffer* indexBuffer
+);
+
+// --- polygons --- //
+
+/**
+Rasterizes the specified clipped and r8ojected polygon. Only the pixels inside 'rect' and the clipping rectangle of the polygon are written.
+\param[in] scanlinesStart Scanline sides with one entry for each row of the frame buffer.
+\param[in] scanlinesEnd Scanline sides with one entry for each row of the frame buffer.
+\remarks This is thread safe as long as each thread uses its own scanlines and the rectangles don't overlap.
+*/
+void r8_render_raster_polygon(
+    R8FrameBuffer* frameBuffer, const R8RasterPolygon* polygon,
+    R8ScalineSide* scanlinesStart, R8ScalineSide* scanlinesEnd, const R8Rect* rect
+);
+
 
 #endif
@@ -10,12 +10,53 @@
 #include "r8_error.h"
 #include "r8_external_math.h"
 #include "r8_color_palette.h"
+#include "r8_global_state.h"
 
 
 static R8StateMachine _nullStateMachine;
 R8StateMachine* stateMachine_ = &_nullStateMachine;
 
 
+// Maps the screen coordinates 'a' and 'b' back into normalized device coordinates (see '_r8oject_vertex' in the renderer).
+static void _ndc_bounds(R8float* bounds, R8float a, R8float b, R8float origin, R8float halfSize)
+{
+    if (halfSize == 0.0f)
+    {
+        // Empty range, so every polygon is clipped in screen space
+        bounds[0] = 1.0f;
+        bounds[1] = -1.0f;
+        return;
+    }
+
+    a = (a - 0.5f - origin) / halfSize - 1.0f;
+    b = (b - 0.5f - origin) / halfSize - 1.0f;
+
+    bounds[0] = R8_MIN(a, b);
+    bounds[1] = R8_MAX(a, b);
+}
+
+/*
+Updates the clipping rectangle and the guard band in normalized device coordinates, which are used for the outcodes
+and the frustum culling in clip space. The bounds enclose the entire border pixels, so they never reject a visible vertex.
+*/
+static void _update_clip_bounds()
+{
+    const R8Viewport* viewport = &(R8_STATE_MACHINE.viewport);
+    const R8Rect* rect = &(R8_STATE_MACHINE.clipRect);
+
+    const R8float left      = (R8float)rect->left;
+    const R8float right     = (R8float)(rect->right + 1);
+    const R8float top       = (R8float)rect->top;
+    const R8float bottom    = (R8float)(rect->bottom + 1);
+    const R8float guardBand = (R8float)R8_GUARD_BAND_SIZE;
+
+    _ndc_bounds(&(stateMachine_->clipBounds[0]), left, right, viewport->x, viewport->halfWidth);
+    _ndc_bounds(&(stateMachine_->clipBounds[2]), top, bottom, viewport->y, viewport->halfHeight);
+
+    _ndc_bounds(&(stateMachine_->guardBandBounds[0]), left - guardBand, right + guardBand, viewport->x, viewport->halfWidth);
+    _ndc_bounds(&(stateMachine_->guardBandBounds[2]), top - guardBand, bottom + guardBand, viewport->y, viewport->halfHeight);
+}
+
 static void _state_machine_clir8ect(R8int left, R8int top, R8int right, R8int bottom)
 {
     stateMachine_->clipRect.left    = left;
@@ -41,6 +82,8 @@ static void _state_machine_clir8ect(R8int left, R8int top, R8int right, R8int bo
     stateMachine_->clipRect.bottom  = bottom;
 
     #endif
+
+    _update_clip_bounds();
 }
 
 static void _update_clir8ect()
@@ -126,6 +169,10 @@ void r8_state_machine_init(R8StateMachine* stateMachine)
 
     stateMachine->states[R8_SCISSOR]        = R8_FALSE;
     stateMachine->states[R8_MIP_MAPPING]    = R8_FALSE;
+    stateMachine->states[R8_HALF_SPACE]     = R8_FALSE;
+    stateMachine->states[R8_HIERARCHICAL_Z] = R8_FALSE;
+    stateMachine->states[R8_DEPTH_PARITY]   = R8_FALSE;
+    stateMachine->states[R8_PRIMITIVE_RESTART] = R8_FALSE;
 
     stateMachine->refCounter                = 0;
 }
@@ -137,6 +184,8 @@ void r8_state_machine_init_null()
 
 void r8_state_machine_makecurrent(R8StateMachine* stateMachine)
 {
+    r8_immediate_mode_flush();
+
     if (stateMachine != NULL)
         stateMachine_ = stateMachine;
     else
@@ -145,6 +194,8 @@ void r8_state_machine_makecurrent(R8StateMachine* stateMachine)
 
 void r8_state_machine_set_state(R8enum cap, R8boolean state)
 {
+    r8_immediate_mode_flush();
+
     if (cap >= R8_NUM_STATES)
     {
         R8_ERROR(R8_ERROR_INDEX_OUT_OF_BOUNDS);
@@ -175,6 +226,8 @@ R8boolean r8_state_machine_get_state(R8enum cap)
 
 void r8_state_machine_set_texenvi(R8enum param, R8int value)
 {
+    r8_immediate_mode_flush();
+
     switch (param)
     {
         case R8_TEXTURE_LOD_BIAS:
@@ -200,6 +253,8 @@ R8int r8_state_machine_get_texenvi(R8enum param)
 
 void r8_state_machine_bind_framebuffer(R8FrameBuffer* frameBuffer)
 {
+    r8_immediate_mode_flush();
+
     R8_STATE_MACHINE.boundFrameBuffer = frameBuffer;
     if (frameBuffer != NULL)
         _state_machine_clir8ect(0, 0, (R8int)frameBuffer->width - 1, (R8int)frameBuffer->height - 1);
@@ -219,11 +274,15 @@ void r8_state_machine_bind_indexbuffer(R8IndexBuffer* indexBuffer)
 
 void r8_state_machine_bind_texture(R8Texture* texture)
 {
+    r8_immediate_mode_flush();
+
     R8_STATE_MACHINE.boundTexture = texture;
 }
 
 void r8_state_machine_viewport(R8int x, R8int y, R8int width, R8int height)
 {
+    r8_immediate_mode_flush();
+
     if (R8_STATE_MACHINE.boundFrameBuffer == NULL)
     {
         R8_ERROR(R8_ERROR_INVALID_STATE);
@@ -257,6 +316,8 @@ void r8_state_machine_viewport(R8int x, R8int y, R8int width, R8int height)
 
 void r8_state_machine_depth_range(R8float minDepth, R8float maxDepth)
 {
+    r8_immediate_mode_flush();
+
     R8_STATE_MACHINE.viewport.minDepth = minDepth;
     R8_STATE_MACHINE.viewport.maxDepth = maxDepth;
     R8_STATE_MACHINE.viewport.depthSize = maxDepth - minDepth;
@@ -264,6 +325,8 @@ void r8_state_machine_depth_range(R8float minDepth, R8float maxDepth)
 
 void r8_state_machine_scissor(R8int x, R8int y, R8int width, R8int height)
 {
+    r8_immediate_mode_flush();
+
     // Store scissor rectangle
     R8_STATE_MACHINE.scissorRect.left   = x;
     R8_STATE_MACHINE.scissorRect.top    = y;
@@ -277,8 +340,25 @@ void r8_state_machine_scissor(R8int x, R8int y, R8int width, R8int height)
     }
 }
 
+void r8_state_machine_scissor_rect(const R8FrameBuffer* frameBuffer, R8Rect* rect)
+{
+    rect->left  = R8_STATE_MACHINE.scissorRect.left;
+    rect->right = R8_STATE_MACHINE.scissorRect.right - 1;
+
+    #ifdef R8_ORIGIN_LEFT_TOP
+    const R8int height = (R8int)frameBuffer->height;
+    rect->top       = height - R8_STATE_MACHINE.scissorRect.bottom;
+    rect->bottom    = height - R8_STATE_MACHINE.scissorRect.top - 1;
+    #else
+    rect->top       = R8_STATE_MACHINE.scissorRect.top;
+    rect->bottom    = R8_STATE_MACHINE.scissorRect.bottom - 1;
+    #endif
+}
+
 void r8_state_machine_cull_mode(R8enum mode)
 {
+    r8_immediate_mode_flush();
+
     if (mode < R8_CULL_NONE || mode > R8_CULL_BACK)
         R8_ERROR(R8_ERROR_INVALID_ARGUMENT);
     else
@@ -287,6 +367,8 @@ void r8_state_machine_cull_mode(R8enum mode)
 
 void r8_state_machine_polygon_mode(R8enum mode)
 {
+    r8_immediate_mode_flush();
+
     if (mode < R8_POLYGON_FILL || mode > R8_POLYGON_POINT)
         R8_ERROR(R8_ERROR_INVALID_ARGUMENT);
     else
@@ -302,17 +384,14 @@ static void _update_viewr8ojection_matrix()
     );
 }
 
-static void _update_worldview_matrix()
+// Updates the world-view and world-view-projection matrices
+static void _update_world_matrices()
 {
     r8_matrix_mul_matrix(
         &(R8_STATE_MACHINE.worldViewMatrix),
         &(R8_STATE_MACHINE.viewMatrix),
         &(R8_STATE_MACHINE.worldMatrix)
     );
-}
-
-static void _update_worldviewr8ojection_matrix()
-{
     r8_matrix_mul_matrix(
         &(R8_STATE_MACHINE.worldViewProjectionMatrix),
         &(R8_STATE_MACHINE.viewProjectionMatrix),
@@ -322,23 +401,27 @@ static void _update_worldviewr8ojection_matrix()
 
 void r8_state_machine_r8ojection_matrix(const R8Matrix4* matrix)
 {
+    r8_immediate_mode_flush();
+
     r8_matrix_copy(&(R8_STATE_MACHINE.r8ojectionMatrix), matrix);
     _update_viewr8ojection_matrix();
-    _update_worldviewr8ojection_matrix();
+    _update_world_matrices();
 }
 
 void r8_state_machine_view_matrix(const R8Matrix4* matrix)
 {
+    r8_immediate_mode_flush();
+
     r8_matrix_copy(&(R8_STATE_MACHINE.viewMatrix), matrix);
     _update_viewr8ojection_matrix();
-    _update_worldview_matrix();
-    _update_worldviewr8ojection_matrix();
+    _update_world_matrices();
 }
 
 void r8_state_machine_world_matrix(const R8Matrix4* matrix)
 {
+    r8_immediate_mode_flush();
+
     r8_matrix_copy(&(R8_STATE_MACHINE.worldMatrix), matrix);
-    _update_worldview_matrix();
-    _update_worldviewr8ojection_matrix();
+    _update_world_matrices();
 }
 
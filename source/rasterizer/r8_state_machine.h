@@ -20,7 +20,7 @@
 
 
 #define R8_STATE_MACHINE    (*stateMachine_)
-#define R8_NUM_STATES       2
+#define R8_NUM_STATES       6
 
 
 typedef struct R8StateMachine
@@ -37,6 +37,8 @@ typedef struct R8StateMachine
     R8Rect             viewportRect;
     R8Rect             scissorRect;
     R8Rect             clipRect;
+    R8float            clipBounds[4];           // Clipping rectangle in normalized device coordinates (min X, max X, min Y, max Y)
+    R8float            guardBandBounds[4];      // Clipping rectangle enlarged by the guard band (see R8_GUARD_BAND_SIZE) in normalized device coordinates
 
     R8FrameBuffer*     boundFrameBuffer;
     R8VertexBuffer*    boundVertexBuffer;
@@ -84,6 +86,9 @@ void r8_state_machine_bind_texture(R8Texture* texture);
 void r8_state_machine_viewport(R8int x, R8int y, R8int width, R8int height);
 void r8_state_machine_depth_range(R8float minDepth, R8float maxDepth);
 void r8_state_machine_scissor(R8int x, R8int y, R8int width, R8int height);
+
+/// Returns the scissor rectangle (inclusive) in the pixel coordinates of the specified frame buffer.
+void r8_state_machine_scissor_rect(const R8FrameBuffer* frameBuffer, R8Rect* rect);
 void r8_state_machine_cull_mode(R8enum mode);
 void r8_state_machine_polygon_mode(R8enum mode);
 
@@ -144,6 +144,7 @@ R8Texture* r8_texture_create()
     texture->width  = 0;
     texture->height = 0;
     texture->mips   = 0;
+    texture->pow2   = R8_FALSE;
     texture->texels = NULL;
 
     for (size_t i = 0; i < R8_MAX_NUM_MIPS; ++i)
@@ -172,6 +173,7 @@ void r8_texture_singular_init(R8Texture* texture)
         texture->width  = 1;
         texture->height = 1;
         texture->mips   = 0;
+        texture->pow2   = R8_FALSE;
         texture->texels = R8_CALLOC(R8ColorBuffer, 1);
     }
 }
@@ -240,6 +242,7 @@ R8boolean r8_texture_image2d(
         texture->width  = width;
         texture->height = height;
         texture->mips   = mips;
+        texture->pow2   = (R8_IS_POW2(width) && R8_IS_POW2(height));
 
         // Free r8evious texels
         R8_FREE(texture->texels);
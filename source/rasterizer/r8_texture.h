@@ -23,6 +23,11 @@
 #define R8_MIP_SIZE(size, mip)      ((size) >> (mip))
 #define R8_TEXTURE_HAS_MIPS(tex)    ((tex)->mips > 1)
 
+#define R8_IS_POW2(size)            ((size) > 0 && ((size) & ((size) - 1)) == 0)
+
+// Number of fractional bits of fixed-point texel coordinates (16.16 format).
+#define R8_TEXCOORD_FIXED_BITS      16
+
 
 /// Textures can have a maximum size of 256x256 texels.
 /// Textures store all their mip maps in a single texel array for compact memory access.
@@ -31,6 +36,7 @@ typedef struct R8Texture
     R8texsize           width;                      /// Width of the first MIP level.
     R8texsize           height;                     /// Height of the first MIP level.
     R8ubyte             mips;                       /// Number of MIP levels.
+    R8boolean           pow2;                       /// Width and height are powers of two, so texels can be sampled with bit masks.
     R8ColorBuffer*       texels;                     /// Texel MIP chain.
     const R8ColorBuffer* mipTexels[R8_MAX_NUM_MIPS]; ///< Texel offsets for the MIP chain (Use a static array for better cache locality).
 }
@@ -76,6 +82,42 @@ const R8ColorBuffer* r8_texture_select_miplevel(const R8Texture* texture, R8ubyt
 /// Samples the nearest texel from the specified MIP-map level.
 R8ColorBuffer r8_texture_sample_nearest_from_mipmap(const R8ColorBuffer* mipTexels, R8texsize mipWidth, R8texsize mipHeight, R8float u, R8float v);
 
+/**
+Samples the nearest texel from a MIP level whose width and height are powers of two.
+'u' and 'v' are texel coordinates in 16.16 fixed point, which are wrapped with bit masks.
+*/
+R8_INLINE R8ColorBuffer r8_texture_sample_nearest_pow2(
+    const R8ColorBuffer* mipTexels, R8ubyte widthShift, R8uint widthMask, R8uint heightMask, R8uint u, R8uint v)
+{
+    const R8uint x = (u >> R8_TEXCOORD_FIXED_BITS) & widthMask;
+    const R8uint y = (v >> R8_TEXCOORD_FIXED_BITS) & heightMask;
+    return mipTexels[(y << widthShift) | x];
+}
+
+/// Converts the specified texture coordinate into a (wrapped) texel coordinate in 16.16 fixed point for a MIP level of the specified size.
+R8_INLINE R8uint r8_texture_fixed_coord(R8double t, R8texsize size)
+{
+    R8int i = (R8int)t;
+    if (t < i)
+        --i;
+    return (R8uint)((t - i) * size * (1 << R8_TEXCOORD_FIXED_BITS));
+}
+
+/// Converts the specified texture coordinate step into a texel coordinate step in 16.16 fixed point for a MIP level of the specified size.
+R8_INLINE R8uint r8_texture_fixed_step(R8double dt, R8texsize size)
+{
+    return (R8uint)(R8int)(dt * size * (1 << R8_TEXCOORD_FIXED_BITS));
+}
+
+/// Returns the binary logarithm of the specified power-of-two size.
+R8_INLINE R8ubyte r8_texture_size_shift(R8texsize size)
+{
+    R8ubyte shift = 0;
+    while ((1 << shift) < size)
+        ++shift;
+    return shift;
+}
+
 /// Samples the nearest texel from the specified texture. MIP-map selection is compuited by tex-coord derivations ddx and ddy.
 R8ColorBuffer r8_texture_sample_nearest(const R8Texture* texture, R8float u, R8float v, R8float ddx, R8float ddy);
 
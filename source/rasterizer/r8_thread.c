@@ -0,0 +1,166 @@
+/*
+ * r8_thread.c
+ *
+ * This file is part of the "R8" (Copyright(c) 2021 by Phani Srikar (Pikachuxxxx))
+ * See "LICENSE.txt" for license information.
+ */
+
+#include "r8_thread.h"
+#include "r8_memory.h"
+
+#include <stdlib.h>
+
+
+// --- internals --- //
+
+typedef struct R8ThreadStart
+{
+    R8_THREAD_PROC  proc;
+    R8void*         arg;
+}
+R8ThreadStart;
+
+#ifdef _WIN32
+static DWORD WINAPI _thread_entry(LPVOID param)
+#else
+static void* _thread_entry(void* param)
+#endif
+{
+    // Copy start parameters, they were allocated by the creating thread
+    R8ThreadStart start = *((R8ThreadStart*)param);
+    free(param);
+
+    start.proc(start.arg);
+
+    return 0;
+}
+
+// --- interface --- //
+
+R8boolean r8_thread_create(R8Thread* thread, R8_THREAD_PROC proc, R8void* arg)
+{
+    R8ThreadStart* start = R8_MALLOC(R8ThreadStart);
+
+    start->proc = proc;
+    start->arg  = arg;
+
+    #ifdef _WIN32
+    *thread = CreateThread(NULL, 0, _thread_entry, start, 0, NULL);
+    if (*thread == NULL)
+    #else
+    if (pthread_create(thread, NULL, _thread_entry, start) != 0)
+    #endif
+    {
+        free(start);
+        return R8_FALSE;
+    }
+
+    return R8_TRUE;
+}
+
+void r8_thread_join(R8Thread thread)
+{
+    #ifdef _WIN32
+    WaitForSingleObject(thread, INFINITE);
+    CloseHandle(thread);
+    #else
+    pthread_join(thread, NULL);
+    #endif
+}
+
+void r8_mutex_init(R8Mutex* mutex)
+{
+    #ifdef _WIN32
+    InitializeCriticalSection(mutex);
+    #else
+    pthread_mutex_init(mutex, NULL);
+    #endif
+}
+
+void r8_mutex_destroy(R8Mutex* mutex)
+{
+    #ifdef _WIN32
+    DeleteCriticalSection(mutex);
+    #else
+    pthread_mutex_destroy(mutex);
+    #endif
+}
+
+void r8_mutex_lock(R8Mutex* mutex)
+{
+    #ifdef _WIN32
+    EnterCriticalSection(mutex);
+    #else
+    pthread_mutex_lock(mutex);
+    #endif
+}
+
+void r8_mutex_unlock(R8Mutex* mutex)
+{
+    #ifdef _WIN32
+    LeaveCriticalSection(mutex);
+    #else
+    pthread_mutex_unlock(mutex);
+    #endif
+}
+
+void r8_condition_init(R8Condition* condition)
+{
+    #ifdef _WIN32
+    InitializeConditionVariable(condition);
+    #else
+    pthread_cond_init(condition, NULL);
+    #endif
+}
+
+void r8_condition_destroy(R8Condition* condition)
+{
+    #ifndef _WIN32
+    pthread_cond_destroy(condition);
+    #endif
+}
+
+void r8_condition_wait(R8Condition* condition, R8Mutex* mutex)
+{
+    #ifdef _WIN32
+    SleepConditionVariableCS(condition, mutex, INFINITE);
+    #else
+    pthread_cond_wait(condition, mutex);
+    #endif
+}
+
+void r8_condition_signal(R8Condition* condition)
+{
+    #ifdef _WIN32
+    WakeConditionVariable(condition);
+    #else
+    pthread_cond_signal(condition);
+    #endif
+}
+
+void r8_condition_broadcast(R8Condition* condition)
+{
+    #ifdef _WIN32
+    WakeAllConditionVariable(condition);
+    #else
+    pthread_cond_broadcast(condition);
+    #endif
+}
+
+R8int r8_atomic_increment(volatile R8int* value)
+{
+    #ifdef _WIN32
+    return (R8int)InterlockedIncrement((volatile LONG*)value);
+    #else
+    return __sync_add_and_fetch(value, 1);
+    #endif
+}
+
+R8int r8_atomic_add(volatile R8int* value, R8int amount)
+{
+    #ifdef _WIN32
+    return (R8int)InterlockedExchangeAdd((volatile LONG*)value, (LONG)amount) + amount;
+    #else
+    return __sync_add_and_fetch(value, amount);
+    #endif
+}
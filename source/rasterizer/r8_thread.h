@@ -0,0 +1,59 @@
+/*
+ * r8_thread.h
+ *
+ * This file is part of the "R8" (Copyright(c) 2021 by Phani Srikar (Pikachuxxxx))
+ * See "LICENSE.txt" for license information.
+ */
+
+#ifndef R8_THREAD_H
+#define R8_THREAD_H
+
+
+#include "r8_types.h"
+
+#ifdef _WIN32
+#   include <Windows.h>
+#else
+#   include <pthread.h>
+#endif
+
+
+#ifdef _WIN32
+typedef HANDLE              R8Thread;
+typedef CRITICAL_SECTION    R8Mutex;
+typedef CONDITION_VARIABLE  R8Condition;
+#else
+typedef pthread_t           R8Thread;
+typedef pthread_mutex_t     R8Mutex;
+typedef pthread_cond_t      R8Condition;
+#endif
+
+/// Thread entry point procedure.
+typedef void (*R8_THREAD_PROC)(R8void* arg);
+
+
+/// Creates a new thread which runs the specified procedure. Returns R8_FALSE on failure.
+R8boolean r8_thread_create(R8Thread* thread, R8_THREAD_PROC proc, R8void* arg);
+
+/// Waits until the specified thread has terminated.
+void r8_thread_join(R8Thread thread);
+
+void r8_mutex_init(R8Mutex* mutex);
+void r8_mutex_destroy(R8Mutex* mutex);
+void r8_mutex_lock(R8Mutex* mutex);
+void r8_mutex_unlock(R8Mutex* mutex);
+
+void r8_condition_init(R8Condition* condition);
+void r8_condition_destroy(R8Condition* condition);
+void r8_condition_wait(R8Condition* condition, R8Mutex* mutex);
+void r8_condition_signal(R8Condition* condition);
+void r8_condition_broadcast(R8Condition* condition);
+
+/// Atomically increments the specified value and returns the new value.
+R8int r8_atomic_increment(volatile R8int* value);
+
+/// Atomically adds 'amount' to the specified value and returns the new value.
+R8int r8_atomic_add(volatile R8int* value, R8int amount);
+
+
+#endif
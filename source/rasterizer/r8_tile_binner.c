@@ -0,0 +1,453 @@
+/*
+ * r8_tile_binner.c
+ *
+ * This file is part of the "R8" (Copyright(c) 2021 by Phani Srikar (Pikachuxxxx))
+ * See "LICENSE.txt" for license information.
+ */
+
+#include "r8_tile_binner.h"
+#include "r8_renderer.h"
+#include "r8_thread.h"
+#include "r8_rect.h"
+#include "r8_external_math.h"
+#include "r8_error.h"
+#include "r8_memory.h"
+
+#include <stdlib.h>
+
+
+// --- internals --- //
+
+/// List of polygon indices, which overlap a single screen tile (in submission order).
+typedef struct R8TileBin
+{
+    R8uint*     polygons;
+    R8uint      numPolygons;
+    R8uint      maxPolygons;
+}
+R8TileBin;
+
+/// Scanline sides for each thread, because the scanlines of the frame buffer can not be shared.
+typedef struct R8TileWorker
+{
+    R8ScalineSide*  scanlinesStart;
+    R8ScalineSide*  scanlinesEnd;
+    R8uint          numScanlines;
+}
+R8TileWorker;
+
+/// Procedure which is called by the worker threads for each job index.
+typedef void (*R8_TILE_JOB_PROC)(R8TileWorker* worker, R8uint index);
+
+typedef struct R8TileBinner
+{
+    // Polygon queue
+    R8RasterPolygon polygons[R8_NUM_BINNED_POLYGONS];
+    R8RasterVertex  vertices[R8_NUM_BINNED_VERTICES];
+    R8uint          numPolygons;
+    R8uint          numVertices;
+
+    // Tiles of the current frame buffer
+    R8FrameBuffer*  frameBuffer;
+    R8TileBin*      bins;
+    R8uint          numTilesX;
+    R8uint          numTilesY;
+    R8uint*         activeTiles;
+    R8uint          numActiveTiles;
+
+    // Worker threads (worker 0 is the main thread)
+    R8int           threadCount;
+    R8Thread        threads[R8_MAX_NUM_THREADS];
+    R8TileWorker    workers[R8_MAX_NUM_THREADS];
+    R8Mutex         mutex;
+    R8Condition     startCondition;
+    R8Condition     finishCondition;
+    R8uint          generation;
+    R8int           numBusyWorkers;
+    R8boolean       quit;
+
+    // Jobs of the current generation
+    R8_TILE_JOB_PROC    jobProc;
+    R8uint              numJobs;
+    volatile R8int      nextJob;
+    R8_PARALLEL_PROC    parallelProc;
+    R8void*             parallelArg;
+}
+R8TileBinner;
+
+static R8TileBinner* _binner = NULL;
+
+static void _worker_reserve_scanlines(R8TileWorker* worker, R8uint height)
+{
+    if (worker->numScanlines < height)
+    {
+        R8_FREE(worker->scanlinesStart);
+        R8_FREE(worker->scanlinesEnd);
+
+        worker->scanlinesStart  = R8_CALLOC(R8ScalineSide, height);
+        worker->scanlinesEnd    = R8_CALLOC(R8ScalineSide, height);
+        worker->numScanlines    = height;
+    }
+}
+
+static void _worker_release_scanlines(R8TileWorker* worker)
+{
+    R8_FREE(worker->scanlinesStart);
+    R8_FREE(worker->scanlinesEnd);
+    worker->numScanlines = 0;
+}
+
+static void _release_bins()
+{
+    if (_binner->bins != NULL)
+    {
+        for (R8uint i = 0, n = _binner->numTilesX * _binner->numTilesY; i < n; ++i)
+            R8_FREE(_binner->bins[i].polygons);
+        R8_FREE(_binner->bins);
+    }
+    R8_FREE(_binner->activeTiles);
+
+    _binner->numTilesX = 0;
+    _binner->numTilesY = 0;
+}
+
+// Makes sure the tile grid matches the dimension of the specified frame buffer.
+static void _setup_bins(R8FrameBuffer* frameBuffer)
+{
+    const R8uint numTilesX = (frameBuffer->width + R8_TILE_SIZE - 1) / R8_TILE_SIZE;
+    const R8uint numTilesY = (frameBuffer->height + R8_TILE_SIZE - 1) / R8_TILE_SIZE;
+
+    if (_binner->bins == NULL || _binner->numTilesX != numTilesX || _binner->numTilesY != numTilesY)
+    {
+        _release_bins();
+
+        _binner->numTilesX      = numTilesX;
+        _binner->numTilesY      = numTilesY;
+        _binner->bins           = R8_CALLOC(R8TileBin, numTilesX*numTilesY);
+        _binner->activeTiles    = R8_CALLOC(R8uint, numTilesX*numTilesY);
+    }
+
+    _binner->frameBuffer = frameBuffer;
+}
+
+static void _bin_push(R8TileBin* bin, R8uint polygonIndex)
+{
+    if (bin->numPolygons == bin->maxPolygons)
+    {
+        // Grow polygon list
+        R8uint maxPolygons = (bin->maxPolygons > 0 ? bin->maxPolygons * 2 : 64);
+        R8uint* polygons = (R8uint*)realloc(bin->polygons, sizeof(R8uint)*maxPolygons);
+
+        if (polygons == NULL)
+        {
+            R8_SET_ERROR_FATAL("out of memory for tile bin");
+            return;
+        }
+
+        bin->polygons       = polygons;
+        bin->maxPolygons    = maxPolygons;
+    }
+    bin->polygons[bin->numPolygons++] = polygonIndex;
+}
+
+// Rasterizes all polygons of the specified active tile (in submission order).
+static void _rasterize_tile(R8TileWorker* worker, R8uint index)
+{
+    R8FrameBuffer* frameBuffer = _binner->frameBuffer;
+    const R8uint tileIndex = _binner->activeTiles[index];
+    R8TileBin* bin = &(_binner->bins[tileIndex]);
+
+    const R8uint tileX = tileIndex % _binner->numTilesX;
+    const R8uint tileY = tileIndex / _binner->numTilesX;
+
+    R8Rect rect;
+    rect.left   = (R8int)(tileX * R8_TILE_SIZE);
+    rect.top    = (R8int)(tileY * R8_TILE_SIZE);
+    rect.right  = R8_MIN(rect.left + R8_TILE_SIZE, (R8int)frameBuffer->width) - 1;
+    rect.bottom = R8_MIN(rect.top + R8_TILE_SIZE, (R8int)frameBuffer->height) - 1;
+
+    for (R8uint i = 0; i < bin->numPolygons; ++i)
+    {
+        r8_render_raster_polygon(
+            frameBuffer,
+            &(_binner->polygons[bin->polygons[i]]),
+            worker->scanlinesStart,
+            worker->scanlinesEnd,
+            &rect
+        );
+    }
+
+    bin->numPolygons = 0;
+}
+
+// Runs a single job of a parallel loop.
+static void _run_parallel_job(R8TileWorker* worker, R8uint index)
+{
+    (void)worker;
+    _binner->parallelProc(index, _binner->parallelArg);
+}
+
+// Grabs jobs from the current generation until all jobs are done.
+static void _run_jobs(R8TileWorker* worker)
+{
+    while (1)
+    {
+        R8int i = r8_atomic_increment(&(_binner->nextJob)) - 1;
+        if (i >= (R8int)_binner->numJobs)
+            break;
+        _binner->jobProc(worker, (R8uint)i);
+    }
+}
+
+// Runs the specified jobs with all worker threads (including the main thread) and waits until they are finished.
+static void _dispatch_jobs(R8_TILE_JOB_PROC proc, R8uint numJobs)
+{
+    _binner->jobProc = proc;
+    _binner->numJobs = numJobs;
+    _binner->nextJob = 0;
+
+    // Wake up worker threads
+    r8_mutex_lock(&(_binner->mutex));
+    {
+        _binner->numBusyWorkers = _binner->threadCount - 1;
+        ++_binner->generation;
+        r8_condition_broadcast(&(_binner->startCondition));
+    }
+    r8_mutex_unlock(&(_binner->mutex));
+
+    // Main thread runs jobs as well
+    _run_jobs(&(_binner->workers[0]));
+
+    // Wait until all worker threads are finished
+    r8_mutex_lock(&(_binner->mutex));
+    {
+        while (_binner->numBusyWorkers > 0)
+            r8_condition_wait(&(_binner->finishCondition), &(_binner->mutex));
+    }
+    r8_mutex_unlock(&(_binner->mutex));
+}
+
+static void _worker_thread_proc(R8void* arg)
+{
+    R8TileWorker* worker = (R8TileWorker*)arg;
+    R8uint generation = 0;
+
+    while (1)
+    {
+        // Wait for next flush
+        r8_mutex_lock(&(_binner->mutex));
+        {
+            while (_binner->generation == generation && !_binner->quit)
+                r8_condition_wait(&(_binner->startCondition), &(_binner->mutex));
+            generation = _binner->generation;
+        }
+        r8_mutex_unlock(&(_binner->mutex));
+
+        if (_binner->quit)
+            break;
+
+        _run_jobs(worker);
+
+        // Notify main thread
+        r8_mutex_lock(&(_binner->mutex));
+        {
+            if (--_binner->numBusyWorkers == 0)
+                r8_condition_signal(&(_binner->finishCondition));
+        }
+        r8_mutex_unlock(&(_binner->mutex));
+    }
+}
+
+static void _stop_worker_threads()
+{
+    r8_mutex_lock(&(_binner->mutex));
+    {
+        _binner->quit = R8_TRUE;
+        r8_condition_broadcast(&(_binner->startCondition));
+    }
+    r8_mutex_unlock(&(_binner->mutex));
+
+    for (R8int i = 1; i < _binner->threadCount; ++i)
+        r8_thread_join(_binner->threads[i]);
+
+    _binner->quit = R8_FALSE;
+    _binner->threadCount = 1;
+}
+
+static void _start_worker_threads(R8int threadCount)
+{
+    _binner->generation = 0;
+
+    for (_binner->threadCount = 1; _binner->threadCount < threadCount; ++_binner->threadCount)
+    {
+        R8int i = _binner->threadCount;
+        if (!r8_thread_create(&(_binner->threads[i]), _worker_thread_proc, &(_binner->workers[i])))
+        {
+            r8_error_set(R8_ERROR_INVALID_STATE, "failed to create rasterizer thread");
+            break;
+        }
+    }
+}
+
+// --- interface --- //
+
+void r8_tile_binner_init()
+{
+    if (_binner != NULL)
+        return;
+
+    _binner = R8_CALLOC(R8TileBinner, 1);
+    _binner->threadCount = 1;
+
+    r8_mutex_init(&(_binner->mutex));
+    r8_condition_init(&(_binner->startCondition));
+    r8_condition_init(&(_binner->finishCondition));
+}
+
+void r8_tile_binner_release()
+{
+    if (_binner == NULL)
+        return;
+
+    r8_tile_binner_flush();
+    _stop_worker_threads();
+
+    for (R8int i = 0; i < R8_MAX_NUM_THREADS; ++i)
+        _worker_release_scanlines(&(_binner->workers[i]));
+    _release_bins();
+
+    r8_condition_destroy(&(_binner->finishCondition));
+    r8_condition_destroy(&(_binner->startCondition));
+    r8_mutex_destroy(&(_binner->mutex));
+
+    R8_FREE(_binner);
+}
+
+void r8_tile_binner_set_thread_count(R8int threadCount)
+{
+    if (_binner == NULL)
+    {
+        R8_ERROR(R8_ERROR_INVALID_STATE);
+        return;
+    }
+    if (threadCount < 1 || threadCount > R8_MAX_NUM_THREADS)
+    {
+        R8_ERROR(R8_ERROR_INVALID_ARGUMENT);
+        return;
+    }
+
+    if (_binner->threadCount != threadCount)
+    {
+        r8_tile_binner_flush();
+        _stop_worker_threads();
+        _start_worker_threads(threadCount);
+    }
+}
+
+R8int r8_tile_binner_get_thread_count()
+{
+    return (_binner != NULL ? _binner->threadCount : 1);
+}
+
+R8boolean r8_tile_binner_active()
+{
+    return (_binner != NULL && _binner->threadCount > 1);
+}
+
+void r8_tile_binner_submit(R8FrameBuffer* frameBuffer, const R8RasterPolygon* polygon)
+{
+    // Flush queue if it's full or polygons for another frame buffer are queued
+    if ( _binner->numPolygons + 1 > R8_NUM_BINNED_POLYGONS ||
+         _binner->numVertices + polygon->numVertices > R8_NUM_BINNED_VERTICES ||
+         (_binner->numPolygons > 0 && _binner->frameBuffer != frameBuffer) )
+    {
+        r8_tile_binner_flush();
+    }
+
+    if (_binner->numPolygons == 0)
+        _setup_bins(frameBuffer);
+
+    // Copy polygon into queue
+    const R8uint polygonIndex = _binner->numPolygons++;
+    R8RasterPolygon* dst = &(_binner->polygons[polygonIndex]);
+    R8RasterVertex* vertices = &(_binner->vertices[_binner->numVertices]);
+
+    *dst = *polygon;
+    dst->vertices = vertices;
+
+    R8int xMin = polygon->vertices[0].x, xMax = xMin;
+    R8int yMin = polygon->vertices[0].y, yMax = yMin;
+
+    for (R8int i = 0; i < polygon->numVertices; ++i)
+    {
+        vertices[i] = polygon->vertices[i];
+        R8_CLAMP_LARGEST(xMax, vertices[i].x);
+        R8_CLAMP_SMALLEST(xMin, vertices[i].x);
+        R8_CLAMP_LARGEST(yMax, vertices[i].y);
+        R8_CLAMP_SMALLEST(yMin, vertices[i].y);
+    }
+
+    _binner->numVertices += (R8uint)polygon->numVertices;
+
+    /*
+    Determine overlapped tiles (with one pixel tolerance for rounded scanline offsets) inside the clipping rectangle,
+    because polygons inside the guard band can exceed the frame buffer by far
+    */
+    const R8int maxTileX = (R8int)_binner->numTilesX - 1;
+    const R8int maxTileY = (R8int)_binner->numTilesY - 1;
+
+    const R8int tileLeft    = R8_CLAMP(R8_MAX(xMin - 1, polygon->clipRect.left) / R8_TILE_SIZE, 0, maxTileX);
+    const R8int tileRight   = R8_CLAMP(R8_MIN(xMax + 1, polygon->clipRect.right) / R8_TILE_SIZE, 0, maxTileX);
+    const R8int tileTop     = R8_CLAMP(R8_MAX(yMin - 1, polygon->clipRect.top) / R8_TILE_SIZE, 0, maxTileY);
+    const R8int tileBottom  = R8_CLAMP(R8_MIN(yMax + 1, polygon->clipRect.bottom) / R8_TILE_SIZE, 0, maxTileY);
+
+    for (R8int y = tileTop; y <= tileBottom; ++y)
+    {
+        for (R8int x = tileLeft; x <= tileRight; ++x)
+        {
+            const R8uint tileIndex = (R8uint)(y * (R8int)_binner->numTilesX + x);
+            R8TileBin* bin = &(_binner->bins[tileIndex]);
+
+            if (bin->numPolygons == 0)
+                _binner->activeTiles[_binner->numActiveTiles++] = tileIndex;
+
+            _bin_push(bin, polygonIndex);
+        }
+    }
+}
+
+void r8_tile_binner_flush()
+{
+    if (_binner == NULL || _binner->numPolygons == 0)
+        return;
+
+    // Make sure each thread has enough scanlines for the frame buffer
+    for (R8int i = 0; i < _binner->threadCount; ++i)
+        _worker_reserve_scanlines(&(_binner->workers[i]), _binner->frameBuffer->height);
+
+    _dispatch_jobs(_rasterize_tile, _binner->numActiveTiles);
+
+    // Reset queue
+    _binner->numPolygons    = 0;
+    _binner->numVertices    = 0;
+    _binner->numActiveTiles = 0;
+}
+
+void r8_tile_binner_parallel_for(R8uint count, R8_PARALLEL_PROC proc, R8void* arg)
+{
+    if (!r8_tile_binner_active())
+    {
+        // Run all jobs on the calling thread
+        for (R8uint i = 0; i < count; ++i)
+            proc(i, arg);
+        return;
+    }
+
+    // Polygons must not be rasterized while the jobs are running
+    r8_tile_binner_flush();
+
+    _binner->parallelProc   = proc;
+    _binner->parallelArg    = arg;
+
+    _dispatch_jobs(_run_parallel_job, count);
+}
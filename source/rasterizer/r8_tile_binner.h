@@ -0,0 +1,58 @@
+/*
+ * r8_tile_binner.h
+ *
+ * This file is part of the "R8" (Copyright(c) 2021 by Phani Srikar (Pikachuxxxx))
+ * See "LICENSE.txt" for license information.
+ */
+
+#ifndef R8_TILE_BINNER_H
+#define R8_TILE_BINNER_H
+
+
+#include "r8_types.h"
+#include "r8_framebuffer.h"
+#include "r8_raster_polygon.h"
+
+
+// Width and height (in pixels) of a screen tile for the sort-middle rasterizer (equal to the clear tiles, so each one is only resolved by a single thread)
+#define R8_TILE_SIZE                R8_CLEAR_TILE_SIZE
+
+// Maximal number of threads (including the main thread) which rasterize tiles in parallel
+#define R8_MAX_NUM_THREADS          32
+
+// Capacity of the polygon queue. The queue will be flushed when it's full.
+#define R8_NUM_BINNED_POLYGONS      8192
+#define R8_NUM_BINNED_VERTICES      (R8_NUM_BINNED_POLYGONS*4)
+
+
+/// Procedure for a single job of a parallel loop.
+typedef void (*R8_PARALLEL_PROC)(R8uint index, R8void* arg);
+
+
+void r8_tile_binner_init();
+void r8_tile_binner_release();
+
+/**
+Sets the number of threads which rasterize the screen tiles.
+A value of 1 disables the sort-middle mode, i.e. all polygons are rasterized immediately by the calling thread.
+*/
+void r8_tile_binner_set_thread_count(R8int threadCount);
+R8int r8_tile_binner_get_thread_count();
+
+/// Returns R8_TRUE if polygons are to be submitted to the binner instead of being rasterized immediately.
+R8boolean r8_tile_binner_active();
+
+/// Copies the specified polygon into the bins of all tiles it overlaps.
+void r8_tile_binner_submit(R8FrameBuffer* frameBuffer, const R8RasterPolygon* polygon);
+
+/// Rasterizes all binned polygons with the worker threads and waits until they are finished.
+void r8_tile_binner_flush();
+
+/**
+Runs the specified procedure for each index in the range [0, count) and waits until all of them are finished.
+The jobs are distributed over the rasterizer threads (including the calling thread), so they must be independent of each other.
+*/
+void r8_tile_binner_parallel_for(R8uint count, R8_PARALLEL_PROC proc, R8void* arg);
+
+
+#endif
@@ -19,16 +19,8 @@
 // Simple vertex with 3D coordinate and 2D texture-coordinate.
 typedef struct R8Vertex
 {
-    // Before vertex processing
     R8Vector4 coord;       // Original coordinate.
     R8Vector2 texCoord;    // Texture-coordinate.
-
-    #if 1// remove!
-    R8Vector4 ndc;         // Normalized device coordinate.
-    #ifdef R8_PERSPECTIVE_CORRECTED
-    R8Vector2 invTexCoord; // Inverse texture-coordinates.
-    #endif
-    #endif
 }
 R8Vertex;
 
@@ -10,16 +10,85 @@
 #include "r8_error.h"
 #include "r8_memory.h"
 #include "r8_config.h"
+#include "r8_external_math.h"
 
 #include <stdlib.h>
+#include <string.h>
 
 
+// --- internals --- //
+
+// Last generation of vertex data, which is shared by all vertex buffers (a new buffer at the address of a deleted one gets a new generation).
+static R8uint _generationCounter = 0;
+
+// Assigns a new generation to the vertex buffer, whose data has been replaced.
+static void _vertexbuffer_new_generation(R8VertexBuffer* vertexBuffer)
+{
+    vertexBuffer->generation = ++_generationCounter;
+}
+
+// Allocates all streams of the vertex buffer in a single block. W is initialized with 1.
+static void _vertexbuffer_alloc(R8VertexBuffer* vertexBuffer, R8sizei numVertices)
+{
+    R8float* streams = R8_CALLOC(R8float, numVertices * 6);
+
+    vertexBuffer->numVertices   = numVertices;
+    vertexBuffer->external      = R8_FALSE;
+    vertexBuffer->hasBounds     = R8_FALSE;
+    vertexBuffer->coords[0]     = streams;
+    vertexBuffer->coords[1]     = streams + numVertices;
+    vertexBuffer->coords[2]     = streams + numVertices * 2;
+    vertexBuffer->coords[3]     = streams + numVertices * 3;
+    vertexBuffer->texCoords[0]  = streams + numVertices * 4;
+    vertexBuffer->texCoords[1]  = streams + numVertices * 5;
+
+    for (R8sizei i = 0; i < numVertices; ++i)
+        vertexBuffer->coords[3][i] = 1.0f;
+}
+
+static void _vertexbuffer_free(R8VertexBuffer* vertexBuffer)
+{
+    if (!vertexBuffer->external)
+        R8_FREE(vertexBuffer->coords[0]);
+
+    vertexBuffer->numVertices = 0;
+    vertexBuffer->external = R8_FALSE;
+    vertexBuffer->hasBounds = R8_FALSE;
+    for (R8int i = 0; i < 4; ++i)
+        vertexBuffer->coords[i] = NULL;
+    for (R8int i = 0; i < 2; ++i)
+        vertexBuffer->texCoords[i] = NULL;
+}
+
+static void _vertexbuffer_resize(R8VertexBuffer* vertexBuffer, R8sizei numVertices)
+{
+    // Check if vertex buffer must be reallocated (external streams are never written)
+    if (vertexBuffer->coords[0] == NULL || vertexBuffer->numVertices != numVertices || vertexBuffer->external)
+    {
+        // Create new vertex buffer data
+        _vertexbuffer_free(vertexBuffer);
+        _vertexbuffer_alloc(vertexBuffer, numVertices);
+    }
+
+    // Bounds are updated after the new vertices have been written
+    vertexBuffer->hasBounds = R8_FALSE;
+
+    _vertexbuffer_new_generation(vertexBuffer);
+}
+
+static void _vertexbuffer_update_bounds(R8VertexBuffer* vertexBuffer)
+{
+    r8_bounds_from_streams(&(vertexBuffer->bounds), (const R8float* const*)vertexBuffer->coords, vertexBuffer->numVertices);
+    vertexBuffer->hasBounds = R8_TRUE;
+}
+
+// --- interface --- //
+
 R8VertexBuffer* r8_vertexbuffer_create()
 {
     R8VertexBuffer* vertexBuffer = R8_MALLOC(R8VertexBuffer);
 
-    vertexBuffer->numVertices   = 0;
-    vertexBuffer->vertices      = NULL;
+    memset(vertexBuffer, 0, sizeof(R8VertexBuffer));
 
     r8_ref_add(vertexBuffer);
 
@@ -32,7 +101,7 @@ void r8_vertexbuffer_delete(R8VertexBuffer* vertexBuffer)
     {
         r8_ref_release(vertexBuffer);
 
-        R8_FREE(vertexBuffer->vertices);
+        _vertexbuffer_free(vertexBuffer);
         R8_FREE(vertexBuffer);
     }
 }
@@ -40,76 +109,81 @@ void r8_vertexbuffer_delete(R8VertexBuffer* vertexBuffer)
 void r8_vertexbuffer_singular_init(R8VertexBuffer* vertexBuffer, R8sizei numVertices)
 {
     if (vertexBuffer != NULL)
-    {
-        vertexBuffer->numVertices   = numVertices;
-        vertexBuffer->vertices      = R8_CALLOC(R8Vertex, numVertices);
-    }
+        _vertexbuffer_alloc(vertexBuffer, numVertices);
 }
 
 void r8_vertexbuffer_singular_clear(R8VertexBuffer* vertexBuffer)
 {
     if (vertexBuffer != NULL)
-        R8_FREE(vertexBuffer->vertices);
+        _vertexbuffer_free(vertexBuffer);
 }
 
-//!REMOVE THIS!
-static void _vertex_transform(
-    R8Vertex* vertex, const R8Matrix4* worldViewProjectionMatrix, const R8Viewport* viewport)
+void r8_vertexbuffer_singular_grow(R8VertexBuffer* vertexBuffer, R8sizei numVertices)
 {
-    // Transform view-space coordinate into r8ojection space
-    r8_matrix_mul_float4(&(vertex->ndc.x), worldViewProjectionMatrix, &(vertex->coord.x));
+    if (vertexBuffer == NULL || numVertices <= vertexBuffer->numVertices)
+        return;
 
-    // Transform coordinate into normalized device coordinates
-    vertex->ndc.z = 1.0f / vertex->ndc.w;
-    vertex->ndc.x *= vertex->ndc.z;
-    vertex->ndc.y *= vertex->ndc.z;
+    // Keep the old streams until their vertices have been copied into the new block
+    R8VertexBuffer oldVertexBuffer = *vertexBuffer;
 
-    // Transform vertex to screen coordinate (+0.5 is for rounding adjustment)
-    vertex->ndc.x = viewport->x + (vertex->ndc.x + 1.0f) * viewport->halfWidth + 0.5f;
-    vertex->ndc.y = viewport->y + (vertex->ndc.y + 1.0f) * viewport->halfHeight + 0.5f;
-    //vertex->ndc.z = viewport->minDepth + vertex->ndc.z * viewport->depthSize;
+    _vertexbuffer_alloc(vertexBuffer, numVertices);
 
-    #ifdef R8_PERSPECTIVE_CORRECTED
-    // Setup inverse-texture coordinates
-    vertex->invTexCoord.x = vertex->texCoord.x * vertex->ndc.z;
-    vertex->invTexCoord.y = vertex->texCoord.y * vertex->ndc.z;
-    #endif
+    for (R8int i = 0; i < 4; ++i)
+        memcpy(vertexBuffer->coords[i], oldVertexBuffer.coords[i], sizeof(R8float) * oldVertexBuffer.numVertices);
+    for (R8int i = 0; i < 2; ++i)
+        memcpy(vertexBuffer->texCoords[i], oldVertexBuffer.texCoords[i], sizeof(R8float) * oldVertexBuffer.numVertices);
+
+    _vertexbuffer_free(&oldVertexBuffer);
 }
 
-void r8_vertexbuffer_transform(
-    R8sizei numVertices, R8sizei firstVertex, R8VertexBuffer* vertexBuffer,
-    const R8Matrix4* worldViewProjectionMatrix, const R8Viewport* viewport)
+void r8_vertexbuffer_reference(R8VertexBuffer* vertexBuffer, R8sizei numVertices, const R8float* const* coords, const R8float* const* texCoords)
 {
-    const R8sizei lastVertex = numVertices + firstVertex;
+    _vertexbuffer_free(vertexBuffer);
 
-    if (lastVertex >= vertexBuffer->numVertices)
-    {
-        r8_error_set(R8_ERROR_INDEX_OUT_OF_BOUNDS, __FUNCTION__);
-        return;
-    }
+    // The streams are only read while drawing, so they can be mapped read-only
+    vertexBuffer->numVertices   = numVertices;
+    vertexBuffer->external      = R8_TRUE;
 
-    for (R8sizei i = firstVertex; i < lastVertex; ++i)
-        _vertex_transform((vertexBuffer->vertices + i), worldViewProjectionMatrix, viewport);
+    for (R8int i = 0; i < 4; ++i)
+        vertexBuffer->coords[i] = (R8float*)coords[i];
+    for (R8int i = 0; i < 2; ++i)
+        vertexBuffer->texCoords[i] = (R8float*)texCoords[i];
+
+    _vertexbuffer_new_generation(vertexBuffer);
 }
 
-void r8_vertexbuffer_transform_all(
-    R8VertexBuffer* vertexBuffer, const R8Matrix4* worldViewProjectionMatrix, const R8Viewport* viewport)
+void r8_vertexbuffer_bounds(R8VertexBuffer* vertexBuffer, const R8float* boundsMin, const R8float* boundsMax)
 {
-    for (R8sizei i = 0; i < vertexBuffer->numVertices; ++i)
-        _vertex_transform((vertexBuffer->vertices + i), worldViewProjectionMatrix, viewport);
+    r8_bounds_from_box(&(vertexBuffer->bounds), boundsMin, boundsMax);
+    vertexBuffer->hasBounds = R8_TRUE;
 }
 
-static void _vertexbuffer_resize(R8VertexBuffer* vertexBuffer, R8sizei numVertices)
+void r8_vertexbuffer_transform_vertex(
+    R8float* clipCoord, const R8VertexBuffer* vertexBuffer, R8sizei index, const R8Matrix4* worldViewProjectionMatrix)
 {
-    // Check if vertex buffer must be reallocated
-    if (vertexBuffer->vertices == NULL || vertexBuffer->numVertices != numVertices)
+    const R8float coord[4] =
     {
-        // Create new vertex buffer data
-        R8_FREE(vertexBuffer->vertices);
+        vertexBuffer->coords[0][index],
+        vertexBuffer->coords[1][index],
+        vertexBuffer->coords[2][index],
+        vertexBuffer->coords[3][index],
+    };
+    r8_matrix_mul_float4(clipCoord, worldViewProjectionMatrix, coord);
+}
 
-        vertexBuffer->numVertices   = numVertices;
-        vertexBuffer->vertices      = R8_CALLOC(R8Vertex, numVertices);
-    }
+void r8_vertexbuffer_transform_batch(
+    R8ClipStream* clipStream, const R8VertexBuffer* vertexBuffer, R8sizei numVertices, R8sizei firstVertex,
+    const R8Matrix4* worldViewProjectionMatrix)
+{
+    const R8float* src[4] =
+    {
+        vertexBuffer->coords[0] + firstVertex,
+        vertexBuffer->coords[1] + firstVertex,
+        vertexBuffer->coords[2] + firstVertex,
+        vertexBuffer->coords[3] + firstVertex,
+    };
+
+    r8_matrix_mul_float4_streams(clipStream->coords, worldViewProjectionMatrix, src, numVertices);
 }
 
 void r8_vertexbuffer_data(R8VertexBuffer* vertexBuffer, R8sizei numVertices, const R8void* coords, const R8void* texCoords, R8sizei vertexStride)
@@ -126,50 +200,46 @@ void r8_vertexbuffer_data(R8VertexBuffer* vertexBuffer, R8sizei numVertices, con
     const R8byte* coordsByteAlign = (const R8byte*)coords;
     const R8byte* texCoordsByteAlign = (const R8byte*)texCoords;
 
-    // Fill vertex buffer
-    R8Vertex* vert = vertexBuffer->vertices;
-
-    while (numVertices-- > 0)
+    // Fill vertex streams (W is always 1, missing components are zero)
+    for (R8sizei i = 0; i < numVertices; ++i)
     {
         // Copy coordinates
         if (coordsByteAlign != NULL)
         {
             const R8float* coord = (const R8float*)coordsByteAlign;
 
-            vert->coord.x = coord[0];
-            vert->coord.y = coord[1];
-            vert->coord.z = coord[2];
-            vert->coord.w = 1.0f;//coord[3];
+            vertexBuffer->coords[0][i] = coord[0];
+            vertexBuffer->coords[1][i] = coord[1];
+            vertexBuffer->coords[2][i] = coord[2];
 
             coordsByteAlign += vertexStride;
         }
         else
         {
-            vert->coord.x = 0.0f;
-            vert->coord.y = 0.0f;
-            vert->coord.z = 0.0f;
-            vert->coord.w = 1.0f;
+            vertexBuffer->coords[0][i] = 0.0f;
+            vertexBuffer->coords[1][i] = 0.0f;
+            vertexBuffer->coords[2][i] = 0.0f;
         }
+        vertexBuffer->coords[3][i] = 1.0f;
 
         // Copy texture coordinates
         if (texCoordsByteAlign != NULL)
         {
             const R8float* texCoord = (const R8float*)texCoordsByteAlign;
 
-            vert->texCoord.x = texCoord[0];
-            vert->texCoord.y = texCoord[1];
+            vertexBuffer->texCoords[0][i] = texCoord[0];
+            vertexBuffer->texCoords[1][i] = texCoord[1];
 
             texCoordsByteAlign += vertexStride;
         }
         else
         {
-            vert->texCoord.x = 0.0f;
-            vert->texCoord.y = 0.0f;
+            vertexBuffer->texCoords[0][i] = 0.0f;
+            vertexBuffer->texCoords[1][i] = 0.0f;
         }
-
-        // Next vertex
-        ++vert;
     }
+
+    _vertexbuffer_update_bounds(vertexBuffer);
 }
 
 void r8_vertexbuffer_data_from_file(R8VertexBuffer* vertexBuffer, R8sizei* numVertices, FILE* file)
@@ -181,17 +251,14 @@ void r8_vertexbuffer_data_from_file(R8VertexBuffer* vertexBuffer, R8sizei* numVe
     }
 
     // Read number of vertices
-    R8ushort vertCount = 0;
-    fread(&vertCount, sizeof(R8ushort), 1, file);
-    *numVertices = (R8sizei)vertCount;
+    *numVertices = r8_file_read_count(file, NULL);
 
     _vertexbuffer_resize(vertexBuffer, *numVertices);
 
     // Read all vertices
     sR8_vertex data;
-    R8Vertex* vert = vertexBuffer->vertices;
 
-    for (R8ushort i = 0; i < *numVertices; ++i)
+    for (R8sizei i = 0; i < *numVertices; ++i)
     {
         if (feof(file))
         {
@@ -202,14 +269,39 @@ void r8_vertexbuffer_data_from_file(R8VertexBuffer* vertexBuffer, R8sizei* numVe
         // Read next vertex data
         fread(&data, sizeof(sR8_vertex), 1, file);
 
-        vert->coord.x = data.x;
-        vert->coord.y = data.y;
-        vert->coord.z = data.z;
-        vert->coord.w = 1.0f;
+        vertexBuffer->coords[0][i] = data.x;
+        vertexBuffer->coords[1][i] = data.y;
+        vertexBuffer->coords[2][i] = data.z;
+        vertexBuffer->coords[3][i] = 1.0f;
 
-        vert->texCoord.x = data.u;
-        vert->texCoord.y = data.v;
+        vertexBuffer->texCoords[0][i] = data.u;
+        vertexBuffer->texCoords[1][i] = data.v;
+    }
 
-        ++vert;
+    _vertexbuffer_update_bounds(vertexBuffer);
+}
+
+void r8_clipstream_reserve(R8ClipStream* clipStream, R8sizei numVertices)
+{
+    if (clipStream->capacity < numVertices)
+    {
+        // Grow by at least 50% to avoid reallocations when the draw sizes increase slowly
+        R8sizei capacity = R8_MAX(numVertices, clipStream->capacity + clipStream->capacity / 2);
+
+        R8_FREE(clipStream->coords[0]);
+        R8float* streams = R8_CALLOC(R8float, capacity * 4);
+
+        clipStream->capacity = capacity;
+        for (R8int i = 0; i < 4; ++i)
+            clipStream->coords[i] = streams + capacity * i;
     }
 }
+
+void r8_clipstream_release(R8ClipStream* clipStream)
+{
+    R8_FREE(clipStream->coords[0]);
+
+    clipStream->capacity = 0;
+    for (R8int i = 0; i < 4; ++i)
+        clipStream->coords[i] = NULL;
+}
@@ -12,17 +12,33 @@
 #include "r8_vertex.h"
 #include "r8_viewport.h"
 #include "r8_structs.h"
+#include "r8_bounds.h"
 
 #include <stdio.h>
 
 
+// Vertex buffer with one tightly packed stream per vertex component (structure of arrays),
+// so that vertices can be transformed in SIMD batches. The streams are read-only while drawing.
 typedef struct R8VertexBuffer
 {
     R8sizei     numVertices;
-    R8Vertex*  vertices;
+    R8float*    coords[4];      // Coordinate streams (X, Y, Z, W).
+    R8float*    texCoords[2];   // Texture-coordinate streams (U, V).
+    R8boolean   external;       // Streams reference external memory (e.g. a mapped mesh file), which is not owned by the buffer.
+    R8Bounds    bounds;         // Bounding volume of all vertices, which is used to cull entire draw calls.
+    R8boolean   hasBounds;      // Bounding volume is valid. Buffers whose vertices are written directly (e.g. for the immediate mode) have no bounds.
+    R8uint      generation;     // Changes with every upload of vertex data, so that derived data (e.g. meshlets) can detect that it is stale.
 }
 R8VertexBuffer;
 
+// Per-draw scratch stream for vertices which have been transformed into clip space (structure of arrays).
+typedef struct R8ClipStream
+{
+    R8sizei     capacity;       // Number of vertices the streams can hold.
+    R8float*    coords[4];      // Clip space coordinate streams (X, Y, Z, W).
+}
+R8ClipStream;
+
 
 R8VertexBuffer* r8_vertexbuffer_create();
 void r8_vertexbuffer_delete(R8VertexBuffer* vertexBuffer);
@@ -30,22 +46,38 @@ void r8_vertexbuffer_delete(R8VertexBuffer* vertexBuffer);
 void r8_vertexbuffer_singular_init(R8VertexBuffer* vertexBuffer, R8sizei numVertices);
 void r8_vertexbuffer_singular_clear(R8VertexBuffer* vertexBuffer);
 
-void r8_vertexbuffer_transform(
-    R8sizei numVertices,
-    R8sizei firstVertex,
-    R8VertexBuffer* vertexBuffer,
-    const R8Matrix4* worldViewProjectionMatrix,
-    const R8Viewport* viewport
+// Enlarges the streams of the singular vertex buffer to 'numVertices' and keeps the current vertices.
+void r8_vertexbuffer_singular_grow(R8VertexBuffer* vertexBuffer, R8sizei numVertices);
+
+// Uses the specified streams in place (zero-copy). They must stay valid until the buffer is deleted or its data is replaced.
+void r8_vertexbuffer_reference(R8VertexBuffer* vertexBuffer, R8sizei numVertices, const R8float* const* coords, const R8float* const* texCoords);
+
+// Sets the bounding volume from a precomputed bounding box (e.g. from a mesh file header), so the vertices don't have to be read.
+void r8_vertexbuffer_bounds(R8VertexBuffer* vertexBuffer, const R8float* boundsMin, const R8float* boundsMax);
+
+// Transforms the single vertex with the specified index into clip space and stores its coordinate in 'clipCoord' (4 floats).
+void r8_vertexbuffer_transform_vertex(
+    R8float* clipCoord,
+    const R8VertexBuffer* vertexBuffer,
+    R8sizei index,
+    const R8Matrix4* worldViewProjectionMatrix
 );
 
-void r8_vertexbuffer_transform_all(
-    R8VertexBuffer* vertexBuffer,
-    const R8Matrix4* worldViewProjectionMatrix,
-    const R8Viewport* viewport
+// Transforms the vertices [firstVertex, firstVertex + numVertices) into clip space, 4 or 8 vertices per iteration.
+// The i-th transformed vertex is stored at index i of the clip stream, which must be reserved for 'numVertices' vertices.
+void r8_vertexbuffer_transform_batch(
+    R8ClipStream* clipStream,
+    const R8VertexBuffer* vertexBuffer,
+    R8sizei numVertices,
+    R8sizei firstVertex,
+    const R8Matrix4* worldViewProjectionMatrix
 );
 
 void r8_vertexbuffer_data(R8VertexBuffer* vertexBuffer, R8sizei numVertices, const R8void* coords, const R8void* texCoords, R8sizei vertexStride);
 void r8_vertexbuffer_data_from_file(R8VertexBuffer* vertexBuffer, R8sizei* numVertices, FILE* file);
 
+void r8_clipstream_reserve(R8ClipStream* clipStream, R8sizei numVertices);
+void r8_clipstream_release(R8ClipStream* clipStream);
+
 
 #endif
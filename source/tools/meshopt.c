@@ -0,0 +1,260 @@
+/*
+ * meshopt.c
+ *
+ * This file is part of the "R8" (Copyright(c) 2021 by Phani Srikar (Pikachuxxxx))
+ * See "LICENSE.txt" for license information.
+ *
+ * Offline optimizer for the ".r8" model files (see 'r8VertexBufferDataFromFile' and 'r8IndexBufferDataFromFile').
+ * It reorders the triangles for vertex cache locality and overdraw, reorders the vertices to match their first use,
+ * and reports the average cache miss ratio (ACMR) before and after.
+ *
+ * Build (only the optimizer library is required):
+ *   cc -std=c99 -O2 -Iinclude -Isource/rasterizer source/tools/meshopt.c source/rasterizer/r8_mesh_optimizer.c -lm -o meshopt
+ */
+
+#include "r8_mesh_optimizer.h"
+#include "r8_structs.h"
+#include "r8_config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+// Escape value of the 16-bit count in the file format, which is followed by a 32-bit count.
+#define COUNT_32BIT 0xFFFF
+
+
+typedef struct Model
+{
+    R8sizei     numVertices;
+    sR8_vertex* vertices;
+    R8sizei     numIndices;
+    R8uint*     indices;
+}
+Model;
+
+
+static R8boolean read_count(FILE* file, R8sizei* count, R8boolean* is32Bit)
+{
+    R8ushort count16 = 0;
+    if (fread(&count16, sizeof(count16), 1, file) != 1)
+        return R8_FALSE;
+
+    *is32Bit = (count16 == COUNT_32BIT);
+
+    if (*is32Bit)
+    {
+        R8uint count32 = 0;
+        if (fread(&count32, sizeof(count32), 1, file) != 1)
+            return R8_FALSE;
+        *count = (R8sizei)count32;
+    }
+    else
+        *count = (R8sizei)count16;
+
+    return R8_TRUE;
+}
+
+static void write_count(FILE* file, R8sizei count, R8boolean is32Bit)
+{
+    if (is32Bit)
+    {
+        const R8ushort escape = COUNT_32BIT;
+        const R8uint count32 = (R8uint)count;
+        fwrite(&escape, sizeof(escape), 1, file);
+        fwrite(&count32, sizeof(count32), 1, file);
+    }
+    else
+    {
+        const R8ushort count16 = (R8ushort)count;
+        fwrite(&count16, sizeof(count16), 1, file);
+    }
+}
+
+static R8boolean load_model(Model* model, const char* filename)
+{
+    FILE* file = fopen(filename, "rb");
+    if (file == NULL)
+        return R8_FALSE;
+
+    R8boolean is32Bit = R8_FALSE, result = R8_FALSE;
+
+    // Read vertices
+    if (read_count(file, &(model->numVertices), &is32Bit))
+    {
+        model->vertices = (sR8_vertex*)calloc((size_t)model->numVertices + 1, sizeof(sR8_vertex));
+
+        if (fread(model->vertices, sizeof(sR8_vertex), (size_t)model->numVertices, file) == (size_t)model->numVertices &&
+            read_count(file, &(model->numIndices), &is32Bit))
+        {
+            // Read indices (16-bit unless the file has a 32-bit count) and expand them to 32 bit
+            model->indices = (R8uint*)calloc((size_t)model->numIndices + 1, sizeof(R8uint));
+
+            result = R8_TRUE;
+
+            for (R8sizei i = 0; i < model->numIndices && result; ++i)
+            {
+                if (is32Bit)
+                    result = (fread(&(model->indices[i]), sizeof(R8uint), 1, file) == 1);
+                else
+                {
+                    R8ushort index = 0;
+                    result = (fread(&index, sizeof(R8ushort), 1, file) == 1);
+                    model->indices[i] = index;
+                }
+
+                if (model->indices[i] >= (R8uint)model->numVertices)
+                    result = R8_FALSE;
+            }
+        }
+    }
+
+    fclose(file);
+    return result;
+}
+
+static R8boolean save_model(const Model* model, const char* filename)
+{
+    FILE* file = fopen(filename, "wb");
+    if (file == NULL)
+        return R8_FALSE;
+
+    // Write vertices
+    write_count(file, model->numVertices, (model->numVertices >= COUNT_32BIT));
+    fwrite(model->vertices, sizeof(sR8_vertex), (size_t)model->numVertices, file);
+
+    // Write indices with 16 bits if possible (a 32-bit count selects 32-bit indices)
+    const R8boolean is32Bit = (model->numIndices >= COUNT_32BIT || model->numVertices > 0x10000);
+    write_count(file, model->numIndices, is32Bit);
+
+    for (R8sizei i = 0; i < model->numIndices; ++i)
+    {
+        if (is32Bit)
+            fwrite(&(model->indices[i]), sizeof(R8uint), 1, file);
+        else
+        {
+            const R8ushort index = (R8ushort)model->indices[i];
+            fwrite(&index, sizeof(R8ushort), 1, file);
+        }
+    }
+
+    R8boolean result = (ferror(file) == 0);
+    fclose(file);
+
+    return result;
+}
+
+static void print_acmr(const char* label, const Model* model, R8sizei cacheSize)
+{
+    printf(
+        "%s ACMR: %.3f (FIFO with %d entries), %.3f (R8 vertex cache with %d entries)\n",
+        label,
+        r8_mesh_optimizer_acmr_fifo(model->indices, model->numIndices, model->numVertices, cacheSize), (int)cacheSize,
+        r8_mesh_optimizer_acmr_direct(model->indices, model->numIndices), R8_VERTEX_CACHE_SIZE
+    );
+}
+
+static void optimize_model(Model* model, R8sizei cacheSize, R8boolean overdraw)
+{
+    // Gather coordinates for the overdraw sorting
+    R8float* coords = NULL;
+
+    if (overdraw)
+    {
+        coords = (R8float*)calloc((size_t)model->numVertices * 3 + 1, sizeof(R8float));
+
+        for (R8sizei i = 0; i < model->numVertices; ++i)
+        {
+            coords[i*3    ] = model->vertices[i].x;
+            coords[i*3 + 1] = model->vertices[i].y;
+            coords[i*3 + 2] = model->vertices[i].z;
+        }
+    }
+
+    // Reorder triangles, then vertices in the order of their first use
+    r8_mesh_optimizer_reorder_triangles(model->indices, model->indices, model->numIndices, model->numVertices, cacheSize, coords);
+
+    R8uint* remap = (R8uint*)calloc((size_t)model->numVertices + 1, sizeof(R8uint));
+    r8_mesh_optimizer_reorder_vertices(remap, model->indices, model->numIndices, model->numVertices);
+
+    sR8_vertex* vertices = (sR8_vertex*)calloc((size_t)model->numVertices + 1, sizeof(sR8_vertex));
+    for (R8sizei i = 0; i < model->numVertices; ++i)
+        vertices[i] = model->vertices[remap[i]];
+
+    free(model->vertices);
+    model->vertices = vertices;
+
+    free(remap);
+    free(coords);
+}
+
+static void print_usage()
+{
+    puts("usage: meshopt [-cache N] [-no-overdraw] INPUT.r8 [OUTPUT.r8]");
+    puts("  -cache N       cache size which is assumed for the triangle reordering (default 16)");
+    puts("  -no-overdraw   don't sort the triangle clusters front to back");
+    puts("  OUTPUT.r8      output file (by default INPUT.r8 is rewritten)");
+}
+
+int main(int argc, char* argv[])
+{
+    R8sizei cacheSize = R8_MESH_OPTIMIZER_CACHE_SIZE;
+    R8boolean overdraw = R8_TRUE;
+    const char* input = NULL;
+    const char* output = NULL;
+
+    // Parse arguments
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "-cache") == 0 && i + 1 < argc)
+            cacheSize = (R8sizei)atoi(argv[++i]);
+        else if (strcmp(argv[i], "-no-overdraw") == 0)
+            overdraw = R8_FALSE;
+        else if (input == NULL)
+            input = argv[i];
+        else if (output == NULL)
+            output = argv[i];
+        else
+        {
+            print_usage();
+            return 1;
+        }
+    }
+
+    if (input == NULL || cacheSize < 3)
+    {
+        print_usage();
+        return 1;
+    }
+    if (output == NULL)
+        output = input;
+
+    // Load, optimize, and save model
+    Model model;
+    memset(&model, 0, sizeof(model));
+
+    if (!load_model(&model, input))
+    {
+        fprintf(stderr, "error: failed to read model file \"%s\"\n", input);
+        return 1;
+    }
+
+    printf("%s: %d vertices, %d triangles\n", input, (int)model.numVertices, (int)(model.numIndices / 3));
+    print_acmr("before", &model, cacheSize);
+
+    optimize_model(&model, cacheSize, overdraw);
+
+    print_acmr("after ", &model, cacheSize);
+
+    if (!save_model(&model, output))
+    {
+        fprintf(stderr, "error: failed to write model file \"%s\"\n", output);
+        return 1;
+    }
+
+    free(model.vertices);
+    free(model.indices);
+
+    return 0;
+}